@@ -48,7 +48,8 @@ extern "C" {
 #define SHA3_384_HMAC_LEN (384/8)
 #define SHA3_512_HMAC_LEN (512/8)
 
-#define HMAC_MAX_KEY_LEN  64
+/** HMAC block size is the SHA3 rate, the longest one is SHA3-224's */
+#define HMAC_MAX_KEY_LEN  (1152/8)
 
 #define IPAD 0x36
 #define OPAD 0x5C
@@ -69,14 +70,18 @@ typedef enum
 
 /**
  * HMAC-SHA3 context.
+ *
+ * Keeps the sponge states after absorbing K ^ ipad and K ^ opad, so a
+ * context set up once per key restarts for every message with
+ * hmac_sha3_reset() instead of absorbing the pads again.
  */
 typedef struct hmac_sha3_ctx
 {
-    uint8_t           ipad[HMAC_MAX_KEY_LEN];                  // inner padding
-    uint8_t           opad[HMAC_MAX_KEY_LEN];                  // outer padding
+    sha3_ctx_t        inner;                                   // state after K ^ ipad
+    sha3_ctx_t        outer;                                   // state after K ^ opad
     sha3_hash_modes_t sha_mode;
-    uint32_t          blocksize;
-    sha3_ctx_t        ctx;
+    size_t            blocksize;
+    sha3_ctx_t        ctx;                                     // running inner hash
 } hmac_sha3_ctx_t;
 
 
@@ -93,7 +98,20 @@ typedef struct hmac_sha3_ctx
 hmac_sha3_status_t hmac_sha3_init(hmac_sha3_hash_mode_t mode,
                                   hmac_sha3_ctx_t *ctx,
                                   const uint8_t *key,
-                                  int key_len);
+                                  size_t key_len);
+
+/**
+ * @brief             Restarts a keyed HMAC-SHA3 context for a new message
+ *
+ * Copies the precomputed inner state, key and pads are not processed
+ * again. Has to follow hmac_sha3_init(), may be called after
+ * hmac_sha3_final() or in the middle of a message.
+ *
+ * @param ctx         [in] HMAC-SHA3 context
+ *
+ * @return            status of operation
+ */
+hmac_sha3_status_t hmac_sha3_reset(hmac_sha3_ctx_t *ctx);
 
 /**
  * @brief             HMAC-SHA3 input data chunks processing
@@ -106,11 +124,14 @@ hmac_sha3_status_t hmac_sha3_init(hmac_sha3_hash_mode_t mode,
  */
 hmac_sha3_status_t hmac_sha3_update(hmac_sha3_ctx_t *ctx,
                                     const uint8_t *input_data,
-                                    uint32_t len);
+                                    size_t len);
 
 /**
  * @brief             Returns HMAC-SHA3 cipher text
  *
+ * The key stays in the context, call hmac_sha3_reset() for the next
+ * message.
+ *
  * @param ctx         [in] HMAC-SHA3 context
  * @param output_data [out] pointer to buffer with cipher text
  *
@@ -133,12 +154,43 @@ hmac_sha3_status_t hmac_sha3_final(hmac_sha3_ctx_t *ctx, uint8_t *output_data);
  */
 hmac_sha3_status_t HMAC_SHA3(hmac_sha3_hash_mode_t mode,
                              const uint8_t *input_data,
-                             uint32_t len,
+                             size_t len,
                              const uint8_t *key,
-                             int key_len,
+                             size_t key_len,
                              uint8_t *output_data);
 
 
+/**
+ * @brief             Verifies a batch of HMAC-SHA3 tags
+ *
+ * Inner and outer hashes of several messages run side by side in the
+ * multi-lane Keccak kernel, tags are compared in constant time. Bit
+ * (i % 8) of result[i / 8] is set when tag[i] is the MAC of
+ * input_data[i] under key[i].
+ *
+ * @param mode        [in] HMAC-SHA3 hash mode
+ * @param key         [in] array of num pointers to keys
+ * @param key_len     [in] array of num key lengths in bytes
+ * @param input_data  [in] array of num pointers to messages
+ * @param len         [in] array of num message lengths in bytes
+ * @param tag         [in] array of num pointers to expected tags
+ * @param tag_len     [in] tag length in bytes, at most the digest length
+ *                    (shorter tags are compared with the MAC prefix)
+ * @param result      [out] pass/fail bitmap of (num + 7) / 8 bytes
+ * @param num         [in] number of triples
+ *
+ * @return            status of operation, HMAC_SHA3_OK also when tags fail
+ */
+hmac_sha3_status_t hmac_sha3_verify_many(hmac_sha3_hash_mode_t mode,
+                                         const uint8_t *const *key,
+                                         const size_t *key_len,
+                                         const uint8_t *const *input_data,
+                                         const size_t *len,
+                                         const uint8_t *const *tag,
+                                         size_t tag_len,
+                                         uint8_t *result,
+                                         uint32_t num);
+
 
 #ifdef  __cplusplus
 }
@@ -0,0 +1,245 @@
+/**
+* @file  keccak.h
+* @brief Keccak-p[1600] permutation kernels.
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __KECCAK_H_
+#define __KECCAK_H_
+
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/** Number of rounds of Keccak-f[1600] */
+#define KECCAK_ROUNDS 24
+
+/** Multi-lane kernels are available for x86-64 GCC/Clang builds */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define KECCAK_HAVE_AVX2   1
+#define KECCAK_HAVE_AVX512 1
+#endif
+
+/** Largest number of states a multi-lane kernel works on */
+#define KECCAK_MAX_LANES 8
+
+/** Environment variable overriding the multi-lane kernel choice */
+#define KECCAK_IMPL_ENV "SHA3_KECCAK_IMPL"
+
+/** Iota round constants */
+extern const uint64_t keccak_rc[KECCAK_ROUNDS];
+
+/**
+ * @brief          Table driven reference Keccak round function
+ *
+ * Keccak-p[1600, rounds]: applies the last 'rounds' of the 24 rounds of
+ * Keccak-f[1600], as all kernels do (12 for TurboSHAKE/KangarooTwelve).
+ *
+ * @param s        [in/out] state, 25 lanes
+ * @param rounds   [in] number of rounds
+ */
+void keccak_fn(uint64_t s[25], uint32_t rounds);
+
+/**
+ * @brief          Fully unrolled Keccak round function
+ *
+ * Keeps the state in locals, processes two rounds per iteration with
+ * constant rotation amounts and uses lane complementing in chi.
+ *
+ * @param s        [in/out] state, 25 lanes
+ * @param rounds   [in] number of rounds, has to be even
+ */
+void keccak_fn_unrolled(uint64_t s[25], uint32_t rounds);
+
+/**
+ * @brief          Keccak round function on 4 interleaved states
+ *
+ * Lane i of state k is stored at s[4 * i + k]. Portable version,
+ * permutes the states one after another.
+ *
+ * @param s        [in/out] 4 interleaved states, 100 lanes
+ * @param rounds   [in] number of rounds
+ */
+void keccak_fn_x4(uint64_t s[25 * 4], uint32_t rounds);
+
+#ifdef KECCAK_HAVE_AVX2
+/**
+ * @brief          AVX2 Keccak round function on 4 interleaved states
+ *
+ * Same layout as keccak_fn_x4, one state per 64-bit lane of a ymm
+ * register. The caller has to check that the CPU supports AVX2.
+ *
+ * @param s        [in/out] 4 interleaved states, 100 lanes
+ * @param rounds   [in] number of rounds
+ */
+void keccak_fn_x4_avx2(uint64_t s[25 * 4], uint32_t rounds);
+#endif
+
+#ifdef KECCAK_HAVE_AVX512
+/**
+ * @brief          AVX-512 Keccak round function on 8 interleaved states
+ *
+ * Lane i of state k is stored at s[8 * i + k], one state per 64-bit lane
+ * of a zmm register. The caller has to check that the CPU supports
+ * AVX-512F.
+ *
+ * @param s        [in/out] 8 interleaved states, 200 lanes
+ * @param rounds   [in] number of rounds
+ */
+void keccak_fn_x8_avx512(uint64_t s[25 * 8], uint32_t rounds);
+#endif
+
+/**
+ * Multi-lane permutation backend.
+ */
+typedef struct keccak_impl
+{
+    const char *name;                              // "avx512", "avx2", "generic"
+    uint32_t    lanes;                             // interleaved states per call
+    void      (*permute)(uint64_t *s, uint32_t rounds);
+    int       (*supported)(void);                  // CPU check
+} keccak_impl_t;
+
+/**
+ * @brief          Returns the multi-lane backend in use
+ *
+ * Chosen once per process on first use: the backend named by the
+ * SHA3_KECCAK_IMPL environment variable if the CPU supports it,
+ * otherwise the fastest supported one.
+ *
+ * @return         backend descriptor, never NULL
+ */
+const keccak_impl_t *keccak_get_impl(void);
+
+/**
+ * @brief          Switches the multi-lane backend
+ *
+ * @param name     [in] backend name, NULL for the fastest supported one
+ *
+ * @return         selected backend or NULL if name is unknown or not
+ *                 supported by the CPU (the current one is kept)
+ */
+const keccak_impl_t *keccak_select_impl(const char *name);
+
+/**
+ * @brief          Keccak round function on a bit-interleaved state
+ *
+ * For 32-bit cores: every lane holds its even bits in the low and its
+ * odd bits in the high 32-bit word (see keccak_interleave()), so a lane
+ * rotation is two 32-bit rotations.
+ *
+ * @param s        [in/out] interleaved state, 25 lanes
+ * @param rounds   [in] number of rounds
+ */
+void keccak_fn_interleaved(uint64_t s[25], uint32_t rounds);
+
+// Even bits of x to the low, odd bits to the high 16 bits
+static inline uint32_t keccak_unshuffle32(uint32_t x)
+{
+    uint32_t t;
+
+    t = (x ^ (x >> 1)) & 0x22222222UL;  x ^= t ^ (t << 1);
+    t = (x ^ (x >> 2)) & 0x0C0C0C0CUL;  x ^= t ^ (t << 2);
+    t = (x ^ (x >> 4)) & 0x00F000F0UL;  x ^= t ^ (t << 4);
+    t = (x ^ (x >> 8)) & 0x0000FF00UL;  x ^= t ^ (t << 8);
+
+    return x;
+}
+
+// Inverse of keccak_unshuffle32()
+static inline uint32_t keccak_shuffle32(uint32_t x)
+{
+    uint32_t t;
+
+    t = (x ^ (x >> 8)) & 0x0000FF00UL;  x ^= t ^ (t << 8);
+    t = (x ^ (x >> 4)) & 0x00F000F0UL;  x ^= t ^ (t << 4);
+    t = (x ^ (x >> 2)) & 0x0C0C0C0CUL;  x ^= t ^ (t << 2);
+    t = (x ^ (x >> 1)) & 0x22222222UL;  x ^= t ^ (t << 1);
+
+    return x;
+}
+
+/**
+ * @brief          Lane to bit-interleaved form
+ *
+ * @param x        [in] lane
+ *
+ * @return         even bits of x in bits 0..31, odd bits in bits 32..63
+ */
+static inline uint64_t keccak_interleave(uint64_t x)
+{
+    uint32_t lo = keccak_unshuffle32((uint32_t)x);
+    uint32_t hi = keccak_unshuffle32((uint32_t)(x >> 32));
+    uint32_t even = (lo & 0x0000FFFFUL) | (hi << 16);
+    uint32_t odd = (lo >> 16) | (hi & 0xFFFF0000UL);
+
+    return (uint64_t)even | ((uint64_t)odd << 32);
+}
+
+/**
+ * @brief          Inverse of keccak_interleave()
+ *
+ * @param x        [in] bit-interleaved lane
+ *
+ * @return         lane
+ */
+static inline uint64_t keccak_deinterleave(uint64_t x)
+{
+    uint32_t even = (uint32_t)x;
+    uint32_t odd = (uint32_t)(x >> 32);
+    uint32_t lo = keccak_shuffle32((even & 0x0000FFFFUL) | (odd << 16));
+    uint32_t hi = keccak_shuffle32((even >> 16) | (odd & 0xFFFF0000UL));
+
+    return (uint64_t)lo | ((uint64_t)hi << 32);
+}
+
+/**
+ * Permutation used by the sponge, selected at build time. The sponge
+ * passes lanes through KECCAK_LANE_IN when absorbing and KECCAK_LANE_OUT
+ * when squeezing, the state stays in the kernel's layout in between.
+ */
+#if defined(SHA3_KECCAK_INTERLEAVED)
+#define KECCAK_PERMUTE     keccak_fn_interleaved
+#define KECCAK_LANE_IN(x)  keccak_interleave(x)
+#define KECCAK_LANE_OUT(x) keccak_deinterleave(x)
+#elif defined(SHA3_KECCAK_UNROLLED)
+#define KECCAK_PERMUTE     keccak_fn_unrolled
+#else
+#define KECCAK_PERMUTE     keccak_fn
+#endif
+
+#ifndef KECCAK_LANE_IN
+#define KECCAK_LANE_IN(x)  (x)
+#define KECCAK_LANE_OUT(x) (x)
+#endif
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif // __KECCAK_H_
@@ -0,0 +1,153 @@
+/**
+* @file  kmac_sha3.h
+* @brief KMAC (SP 800-185) module main interface
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  04.01.2014
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __KMAC_SHA3_H_
+#define __KMAC_SHA3_H_
+
+#include <stdint.h>
+
+#include "sha3.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/**
+ * KMAC definitions.
+ */
+
+/** Default KMAC tag length for modes (in bytes) */
+#define KMAC_SHA3_128_LEN (256/8)
+#define KMAC_SHA3_256_LEN (512/8)
+
+typedef enum
+{
+	KMAC_SHA3_128 = 0,
+	KMAC_SHA3_256
+} kmac_sha3_mode_t;
+
+typedef enum
+{
+	KMAC_SHA3_OK = 0,
+	KMAC_SHA3_ERROR
+}kmac_sha3_status_t;
+
+/**
+ * KMAC context.
+ *
+ * KMAC is keyed cSHAKE: the key is absorbed once in front of the
+ * message, a tag costs a single sponge pass.
+ */
+typedef struct kmac_sha3_ctx
+{
+    sha3_ctx_t        ctx;
+} kmac_sha3_ctx_t;
+
+
+/**
+ * @brief             KMAC context setup
+ *
+ * @param mode        [in] KMAC mode
+ * @param ctx         [in] pointer to context to be initialized
+ * @param key         [in] pointer to key buffer
+ * @param key_len     [in] key buffer len in bytes
+ * @param custom      [in] customization string S, may be NULL if custom_len is 0
+ * @param custom_len  [in] S length in bytes
+ *
+ * @return            status of operation
+ */
+kmac_sha3_status_t kmac_sha3_init(kmac_sha3_mode_t mode,
+                                  kmac_sha3_ctx_t *ctx,
+                                  const uint8_t *key,
+                                  size_t key_len,
+                                  const uint8_t *custom,
+                                  size_t custom_len);
+
+/**
+ * @brief             KMAC input data chunks processing
+ *
+ * @param ctx         [in] KMAC context
+ * @param input_data  [in] pointer to buffer with plain data chunck
+ * @param len         [in] plain data chunk len in bytes
+ *
+ * @return            status of operation
+ */
+kmac_sha3_status_t kmac_sha3_update(kmac_sha3_ctx_t *ctx,
+                                    const uint8_t *input_data,
+                                    size_t len);
+
+/**
+ * @brief             Returns KMAC tag
+ *
+ * The tag length is bound into the tag, a shorter tag is not a prefix
+ * of a longer one.
+ *
+ * @param ctx         [in] KMAC context
+ * @param output_data [out] pointer to buffer for the tag
+ * @param output_len  [in] tag length in bytes
+ *
+ * @return            status of operation
+ */
+kmac_sha3_status_t kmac_sha3_final(kmac_sha3_ctx_t *ctx,
+                                   uint8_t *output_data,
+                                   size_t output_len);
+
+
+/**
+ * @brief             KMAC single data chunk processing
+ *
+ * @param mode        [in] KMAC mode
+ * @param input_data  [in] pointer to buffer with plain data chunck
+ * @param len         [in] plain data chunk len in bytes
+ * @param key         [in] pointer to key buffer
+ * @param key_len     [in] key buffer len in bytes
+ * @param custom      [in] customization string S, may be NULL if custom_len is 0
+ * @param custom_len  [in] S length in bytes
+ * @param output_data [out] pointer to buffer for the tag
+ * @param output_len  [in] tag length in bytes
+ *
+ * @return            status of operation
+ */
+kmac_sha3_status_t KMAC_SHA3(kmac_sha3_mode_t mode,
+                             const uint8_t *input_data,
+                             size_t len,
+                             const uint8_t *key,
+                             size_t key_len,
+                             const uint8_t *custom,
+                             size_t custom_len,
+                             uint8_t *output_data,
+                             size_t output_len);
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+
+#endif // __KMAC_SHA3_H_
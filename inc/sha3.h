@@ -30,6 +30,9 @@
 #ifndef __SHA3_H_
 #define __SHA3_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
@@ -39,6 +42,30 @@ extern "C" {
 #define SHA3_384_HASH_LEN (384/8)
 #define SHA3_512_HASH_LEN (512/8)
 
+/** Keccak-f[1600] state size in bytes */
+#define SHA3_STATE_LEN    (1600/8)
+
+/** Largest rate (block size) in bytes: 1600 - 2*128 bits of capacity */
+#define SHA3_MAX_RATE_LEN ((1600 - 256)/8)
+
+/** Longest SP 800-185 left_encode/right_encode output */
+#define SHA3_ENCODE_MAX_LEN 9
+
+/** SHAKE default output length for sha3_final (in bytes) */
+#define SHAKE128_HASH_LEN (256/8)
+#define SHAKE256_HASH_LEN (512/8)
+
+/** KangarooTwelve chunk size (in bytes) */
+#define K12_CHUNK_LEN     8192
+
+/** Pipelined fd reader defaults: ring slots and slot size in bytes */
+#define SHA3_PIPE_SLOTS         4
+#define SHA3_PIPE_SLOT_LEN      ((size_t)1 << 20)
+
+/** Prefix cache size: number of states and longest cached prefix in bytes */
+#define SHA3_PREFIX_CACHE_SLOTS 8
+#define SHA3_PREFIX_MAX_LEN     1024
+
 /**
  * SHA3 (Keccak) modes.
  */
@@ -47,7 +74,11 @@ typedef enum sha3_hash_modes
 	SHA3_224 = 0,
 	SHA3_256,
 	SHA3_384,
-	SHA3_512
+	SHA3_512,
+	SHAKE128,                      // extendable output
+	SHAKE256,                      // extendable output
+	TURBOSHAKE128,                 // extendable output, 12 rounds
+	TURBOSHAKE256                  // extendable output, 12 rounds
 } sha3_hash_modes_t;
 
 /**
@@ -63,13 +94,42 @@ typedef enum
  * SHA3 (Keccak) context.
  */
 typedef struct sha3_ctx{
-        uint8_t a[200];
+        uint64_t s[SHA3_STATE_LEN/8];          // state lanes
+        uint8_t  buf[SHA3_MAX_RATE_LEN];       // pending partial block
         uint16_t r;
         uint16_t c;
         uint16_t d;
         uint8_t  bs;
+        uint8_t  buf_len;                      // bytes pending in buf / squeezed from block
+        uint8_t  pad;                          // domain and first padding bits
+        uint8_t  rounds;                       // Keccak-p[1600] rounds
+        uint8_t  flags;
 } sha3_ctx_t;
 
+/**
+ * Cached state after absorbing a prefix.
+ */
+typedef struct sha3_prefix_entry
+{
+        sha3_ctx_t ctx;
+        uint32_t   mode;
+        uint32_t   stamp;                      // last use, 0 for a free slot
+        size_t     len;
+        uint8_t    prefix[SHA3_PREFIX_MAX_LEN];
+} sha3_prefix_entry_t;
+
+/**
+ * Least recently used cache of prefix states, not thread safe: one per
+ * thread or behind a lock.
+ */
+typedef struct sha3_prefix_cache
+{
+        sha3_prefix_entry_t entry[SHA3_PREFIX_CACHE_SLOTS];
+        uint32_t            clock;
+        uint32_t            hits;
+        uint32_t            misses;
+} sha3_prefix_cache_t;
+
 /**
  * @brief          SHA3 context setup
  *
@@ -80,9 +140,23 @@ typedef struct sha3_ctx{
  */
 sha3_status_t sha3_init(sha3_hash_modes_t mode, sha3_ctx_t *ctx); 
 
+/**
+ * @brief          TurboSHAKE context setup
+ *
+ * @param mode     [in] TURBOSHAKE128 or TURBOSHAKE256
+ * @param ctx      [in] pointer to context to be initialized
+ * @param domain   [in] domain separation byte, 0x01..0x7F (0x1F by default)
+ *
+ * @return         status of operation
+ */
+sha3_status_t sha3_turboshake_init(sha3_hash_modes_t mode, sha3_ctx_t *ctx, uint8_t domain);
+
 /**
  * @brief             SHA3 input data chunks processing
  *
+ * Full rate blocks are XORed into the state directly from input_data,
+ * only the trailing partial block is buffered in the context.
+ *
  * @param ctx         [in] SHA3 context
  * @param input_data  [in] pointer to buffer with plain data chunck
  * @param len         [in] plain data chunk len in bytes
@@ -90,11 +164,14 @@ sha3_status_t sha3_init(sha3_hash_modes_t mode, sha3_ctx_t *ctx);
  * @return            status of operation
  */
 
-sha3_status_t sha3_update(sha3_ctx_t *ctx, const uint8_t *input_data, uint32_t len);
+sha3_status_t sha3_update(sha3_ctx_t *ctx, const uint8_t *input_data, size_t len);
 
 /**
  * @brief             Returns SHA3 hash
  *
+ * Pads and finishes the sponge, ctx has to be initialized again before reuse.
+ * SHAKE modes return the first SHAKE128_HASH_LEN/SHAKE256_HASH_LEN bytes.
+ *
  * @param ctx         [in] SHA3 context
  * @param output_data [out] pointer to buffer with hash
  *
@@ -102,6 +179,166 @@ sha3_status_t sha3_update(sha3_ctx_t *ctx, const uint8_t *input_data, uint32_t l
  */
 sha3_status_t sha3_final(sha3_ctx_t *ctx, uint8_t *output_data);
 
+/**
+ * @brief             Returns SHA3 hash of the data absorbed so far
+ *
+ * Same output as sha3_final, but ctx is left as it was: more data may
+ * be absorbed and the call repeated.
+ *
+ * @param ctx         [in] SHA3 context
+ * @param output_data [out] pointer to buffer with hash
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_final_keep(const sha3_ctx_t *ctx, uint8_t *output_data);
+
+/**
+ * @brief             Copies a context
+ *
+ * Forks a hash, e.g. after a common prefix. Only the pending part of
+ * the block buffer is copied.
+ *
+ * @param dst         [out] destination context
+ * @param src         [in] source context
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_ctx_clone(sha3_ctx_t *dst, const sha3_ctx_t *src);
+
+/**
+ * @brief             Empties a prefix cache
+ *
+ * @param cache       [in] prefix cache
+ */
+void sha3_prefix_cache_init(sha3_prefix_cache_t *cache);
+
+/**
+ * @brief             Context that has absorbed a prefix, from the cache
+ *
+ * On a hit the cached state is cloned into ctx. On a miss the prefix is
+ * absorbed and, if it is at most SHA3_PREFIX_MAX_LEN bytes long, the state
+ * replaces the least recently used entry. Prefixes are compared byte by
+ * byte, ctx continues with sha3_update/sha3_final as usual.
+ *
+ * @param cache       [in] prefix cache
+ * @param mode        [in] SHA3 hash mode
+ * @param prefix      [in] prefix bytes
+ * @param len         [in] prefix length in bytes
+ * @param ctx         [out] context to continue
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_prefix_ctx(sha3_prefix_cache_t *cache,
+                              sha3_hash_modes_t mode,
+                              const uint8_t *prefix,
+                              size_t len,
+                              sha3_ctx_t *ctx);
+
+/**
+ * @brief             SHAKE output, may be called repeatedly
+ *
+ * The first call pads the input, every call continues the output
+ * stream where the previous one stopped. The state is permuted only
+ * when the current rate block is used up.
+ *
+ * @param ctx         [in] SHA3 context initialized for SHAKE128/SHAKE256
+ * @param output_data [out] pointer to output buffer
+ * @param len         [in] number of bytes to squeeze
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_squeeze(sha3_ctx_t *ctx, uint8_t *output_data, size_t len);
+
+/**
+ * @brief             Duplex object setup
+ *
+ * ctx holds a zero Keccak state with the rate and rounds of mode and is
+ * driven only by the sha3_duplex_* calls. Every call absorbs one block
+ * of less than the rate (at most bs - 1 bytes, e.g. 167 for SHAKE128)
+ * with its domain bits and pad10*1 and applies one permutation.
+ *
+ * @param mode        [in] SHA3 hash mode, gives rate and rounds
+ * @param ctx         [in] pointer to context to be initialized
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_duplex_init(sha3_hash_modes_t mode, sha3_ctx_t *ctx);
+
+/**
+ * @brief             Duplexing call: absorbs a block, returns output
+ *
+ * The domain byte holds the domain bits followed by the first padding
+ * bit as in the sponge modes (0x06 gives SHA3, 0x1F SHAKE): on a fresh
+ * context the output equals the hash of the block.
+ *
+ * @param ctx         [in] duplex context
+ * @param input_data  [in] block, NULL only when len is 0
+ * @param len         [in] block length in bytes, less than the rate
+ * @param domain      [in] domain and first padding bits, 0x01..0x7F
+ * @param output_data [out] output buffer, may be NULL if output_len is 0
+ * @param output_len  [in] output length in bytes, at most the rate
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_duplex(sha3_ctx_t *ctx,
+                          const uint8_t *input_data,
+                          size_t len,
+                          uint8_t domain,
+                          uint8_t *output_data,
+                          size_t output_len);
+
+/**
+ * @brief             Reads the rate of the current duplex state
+ *
+ * No permutation: repeated calls return the same bytes, e.g. a tag
+ * after the last sha3_duplex_encrypt.
+ *
+ * @param ctx         [in] duplex context
+ * @param output_data [out] output buffer
+ * @param len         [in] output length in bytes, at most the rate
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_duplex_output(const sha3_ctx_t *ctx, uint8_t *output_data, size_t len);
+
+/**
+ * @brief             Encrypts a block with the duplex
+ *
+ * output_data is input_data XOR the rate of the current state, then the
+ * plaintext is absorbed as by sha3_duplex: one permutation covers both
+ * keystream and authentication. Buffers may be the same.
+ *
+ * @param ctx         [in] keyed duplex context
+ * @param input_data  [in] plaintext block
+ * @param output_data [out] ciphertext block
+ * @param len         [in] block length in bytes, less than the rate
+ * @param domain      [in] domain and first padding bits, 0x01..0x7F
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_duplex_encrypt(sha3_ctx_t *ctx,
+                                  const uint8_t *input_data,
+                                  uint8_t *output_data,
+                                  size_t len,
+                                  uint8_t domain);
+
+/**
+ * @brief             Decrypts a block encrypted by sha3_duplex_encrypt
+ *
+ * @param ctx         [in] keyed duplex context
+ * @param input_data  [in] ciphertext block
+ * @param output_data [out] plaintext block
+ * @param len         [in] block length in bytes, less than the rate
+ * @param domain      [in] domain and first padding bits, 0x01..0x7F
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_duplex_decrypt(sha3_ctx_t *ctx,
+                                  const uint8_t *input_data,
+                                  uint8_t *output_data,
+                                  size_t len,
+                                  uint8_t domain);
+
 /**
  * @brief             HSHA3 single data chunk processing
  *
@@ -114,9 +351,336 @@ sha3_status_t sha3_final(sha3_ctx_t *ctx, uint8_t *output_data);
  */
 sha3_status_t SHA3(sha3_hash_modes_t mode,
                    const uint8_t *input_data,
-                   uint32_t len,
+                   size_t len,
                    uint8_t *output_data);
 
+/**
+ * @brief             Hash of exactly 32 bytes in a single permutation
+ *
+ * The input fits in one rate block of every mode: its lanes and the
+ * padding go straight into the state, no context is set up. SHAKE and
+ * TurboSHAKE (domain 0x1F) modes give their default output length.
+ *
+ * @param mode        [in] SHA3 hash mode
+ * @param input_data  [in] 32 bytes
+ * @param output_data [out] digest of the mode's digest length
+ *
+ * @return            status of operation
+ */
+sha3_status_t SHA3_32(sha3_hash_modes_t mode, const uint8_t *input_data, uint8_t *output_data);
+
+/**
+ * @brief             Hash of exactly 64 bytes in a single permutation
+ *
+ * As SHA3_32() for 64 bytes of input (a pair of 256-bit nodes/keys).
+ *
+ * @param mode        [in] SHA3 hash mode
+ * @param input_data  [in] 64 bytes
+ * @param output_data [out] digest of the mode's digest length
+ *
+ * @return            status of operation
+ */
+sha3_status_t SHA3_64(sha3_hash_modes_t mode, const uint8_t *input_data, uint8_t *output_data);
+
+/**
+ * @brief             SHAKE single data chunk processing
+ *
+ * @param mode        [in] SHAKE128 or SHAKE256
+ * @param input_data  [in] pointer to buffer with plain data chunck
+ * @param len         [in] plain data chunk len in bytes
+ * @param output_data [out] pointer to output buffer
+ * @param output_len  [in] output length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t SHAKE(sha3_hash_modes_t mode,
+                    const uint8_t *input_data,
+                    size_t len,
+                    uint8_t *output_data,
+                    size_t output_len);
+
+/**
+ * @brief             TurboSHAKE single data chunk processing
+ *
+ * @param mode        [in] TURBOSHAKE128 or TURBOSHAKE256
+ * @param domain      [in] domain separation byte, 0x01..0x7F
+ * @param input_data  [in] pointer to buffer with plain data chunck
+ * @param len         [in] plain data chunk len in bytes
+ * @param output_data [out] pointer to output buffer
+ * @param output_len  [in] output length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t TURBOSHAKE(sha3_hash_modes_t mode,
+                         uint8_t domain,
+                         const uint8_t *input_data,
+                         size_t len,
+                         uint8_t *output_data,
+                         size_t output_len);
+
+/**
+ * @brief             cSHAKE (SP 800-185) context setup
+ *
+ * Absorbs bytepad(encode_string(name) || encode_string(custom)), input
+ * and output then go through sha3_update/sha3_squeeze. With empty name
+ * and custom strings the context is plain SHAKE.
+ *
+ * @param mode        [in] SHAKE128 or SHAKE256
+ * @param ctx         [in] pointer to context to be initialized
+ * @param name        [in] function name string N
+ * @param name_len    [in] N length in bytes
+ * @param custom      [in] customization string S
+ * @param custom_len  [in] S length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_cshake_init(sha3_hash_modes_t mode,
+                               sha3_ctx_t *ctx,
+                               const uint8_t *name,
+                               size_t name_len,
+                               const uint8_t *custom,
+                               size_t custom_len);
+
+/**
+ * @brief             cSHAKE single data chunk processing
+ *
+ * @param mode        [in] SHAKE128 or SHAKE256
+ * @param input_data  [in] pointer to buffer with plain data chunck
+ * @param len         [in] plain data chunk len in bytes
+ * @param name        [in] function name string N
+ * @param name_len    [in] N length in bytes
+ * @param custom      [in] customization string S
+ * @param custom_len  [in] S length in bytes
+ * @param output_data [out] pointer to output buffer
+ * @param output_len  [in] output length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t CSHAKE(sha3_hash_modes_t mode,
+                     const uint8_t *input_data,
+                     size_t len,
+                     const uint8_t *name,
+                     size_t name_len,
+                     const uint8_t *custom,
+                     size_t custom_len,
+                     uint8_t *output_data,
+                     size_t output_len);
+
+/**
+ * @brief             ParallelHash (SP 800-185) single data chunk processing
+ *
+ * The input is split into block_size leaves hashed in parallel on the
+ * multi-lane kernel and the worker pool, their chaining values are
+ * absorbed in order. Small inputs are hashed on the calling thread.
+ *
+ * @param mode        [in] SHAKE128 for ParallelHash128, SHAKE256 for ParallelHash256
+ * @param input_data  [in] pointer to buffer with plain data chunck
+ * @param len         [in] plain data chunk len in bytes
+ * @param block_size  [in] leaf size B in bytes
+ * @param custom      [in] customization string S
+ * @param custom_len  [in] S length in bytes
+ * @param output_data [out] pointer to output buffer
+ * @param output_len  [in] output length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t PARALLELHASH(sha3_hash_modes_t mode,
+                           const uint8_t *input_data,
+                           size_t len,
+                           size_t block_size,
+                           const uint8_t *custom,
+                           size_t custom_len,
+                           uint8_t *output_data,
+                           size_t output_len);
+
+/**
+ * @brief             KangarooTwelve single data chunk processing
+ *
+ * 8 KiB chunks after the first one are hashed in parallel on the
+ * multi-lane kernel and the worker pool.
+ *
+ * @param mode        [in] TURBOSHAKE128 for KT128, TURBOSHAKE256 for KT256
+ * @param input_data  [in] pointer to buffer with plain data chunck
+ * @param len         [in] plain data chunk len in bytes
+ * @param custom      [in] customization string C
+ * @param custom_len  [in] C length in bytes
+ * @param output_data [out] pointer to output buffer
+ * @param output_len  [in] output length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t KANGAROOTWELVE(sha3_hash_modes_t mode,
+                             const uint8_t *input_data,
+                             size_t len,
+                             const uint8_t *custom,
+                             size_t custom_len,
+                             uint8_t *output_data,
+                             size_t output_len);
+
+/**
+ * @brief             Sets the number of threads of the parallel modes
+ *
+ * @param threads     [in] thread count including the caller, 0 for one
+ *                    per online CPU (the default)
+ */
+void sha3_set_threads(uint32_t threads);
+
+/**
+ * @brief             SP 800-185 left_encode(x)
+ *
+ * @param x           [in] value to encode
+ * @param output_data [out] buffer of SHA3_ENCODE_MAX_LEN bytes
+ *
+ * @return            encoding length in bytes
+ */
+uint32_t sha3_left_encode(uint64_t x, uint8_t *output_data);
+
+/**
+ * @brief             SP 800-185 right_encode(x)
+ *
+ * @param x           [in] value to encode
+ * @param output_data [out] buffer of SHA3_ENCODE_MAX_LEN bytes
+ *
+ * @return            encoding length in bytes
+ */
+uint32_t sha3_right_encode(uint64_t x, uint8_t *output_data);
+
+/**
+ * @brief             Absorbs bytepad(encode_string(str[0]) || ..., rate)
+ *
+ * Has to be called on a block boundary, e.g. right after init.
+ *
+ * @param ctx         [in] SHA3 context
+ * @param str         [in] num strings
+ * @param len         [in] num string lengths in bytes
+ * @param num         [in] number of strings
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_update_bytepad(sha3_ctx_t *ctx,
+                                  const uint8_t *const str[],
+                                  const size_t len[],
+                                  uint32_t num);
+
+/**
+ * @brief             SHA3 of 4 independent messages at once
+ *
+ * The messages are hashed in interleaved Keccak states of the
+ * multi-lane kernel (AVX-512 or AVX2 when the CPU supports it),
+ * lengths may differ inside the batch.
+ * Digests are identical to the ones returned by SHA3().
+ *
+ * @param mode        [in] SHA3 hash mode
+ * @param input_data  [in] pointers to the 4 plain data buffers
+ * @param len         [in] plain data lengths in bytes
+ * @param output_data [out] pointers to the 4 hash buffers
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_hash_x4(sha3_hash_modes_t mode,
+                           const uint8_t *const input_data[4],
+                           const size_t len[4],
+                           uint8_t *const output_data[4]);
+
+/**
+ * @brief             SHA3 of num independent messages
+ *
+ * Messages are processed as many at a time as the multi-lane kernel
+ * has lanes (4 for AVX2, 8 for AVX-512).
+ *
+ * @param mode        [in] SHA3 hash mode
+ * @param input_data  [in] array of num pointers to plain data buffers
+ * @param len         [in] array of num plain data lengths in bytes
+ * @param output_data [out] array of num pointers to hash buffers
+ * @param num         [in] number of messages
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_hash_many(sha3_hash_modes_t mode,
+                             const uint8_t *const *input_data,
+                             const size_t *len,
+                             uint8_t *const *output_data,
+                             uint32_t num);
+
+/**
+ * @brief             TurboSHAKE of num independent messages
+ *
+ * @param mode        [in] TURBOSHAKE128 or TURBOSHAKE256
+ * @param domain      [in] domain separation byte, 0x01..0x7F
+ * @param input_data  [in] array of num pointers to plain data buffers
+ * @param len         [in] array of num plain data lengths in bytes
+ * @param output_data [out] array of num pointers to output buffers
+ * @param output_len  [in] output length in bytes, at most one rate block
+ * @param num         [in] number of messages
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_turboshake_many(sha3_hash_modes_t mode,
+                                   uint8_t domain,
+                                   const uint8_t *const *input_data,
+                                   const size_t *len,
+                                   uint8_t *const *output_data,
+                                   size_t output_len,
+                                   uint32_t num);
+
+/**
+ * @brief             Absorbs everything readable from a file descriptor
+ *
+ * Regular files are memory mapped from the current offset with sequential
+ * access hints and absorbed in place, pipes and special files are read in
+ * large chunks. The descriptor is left at end of file. A mapped file must
+ * not be truncated while it is being hashed.
+ *
+ * @param ctx         [in] SHA3 context
+ * @param fd          [in] open file descriptor
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_update_fd(sha3_ctx_t *ctx, int fd);
+
+/**
+ * @brief             Absorbs a stream with read() on a second thread
+ *
+ * A reader thread fills a single-producer/single-consumer ring of page
+ * aligned slots while the calling thread absorbs the slots already
+ * filled, so I/O and the permutation overlap: throughput is the slower
+ * of the two rather than their sum. The reader waits while the ring is
+ * full. A slot is handed over when it is full, at end of input or as
+ * soon as the hashing side runs dry. Meant for pipes and sockets,
+ * regular files are hashed faster by sha3_update_fd.
+ *
+ * @param ctx         [in] SHA3 context
+ * @param fd          [in] open file descriptor, read to end of input
+ * @param tee_fd      [in] descriptor that gets a copy of the data, -1 for none
+ * @param slots       [in] ring size, at least 2, 0 for SHA3_PIPE_SLOTS
+ * @param slot_len    [in] slot size in bytes, 0 for SHA3_PIPE_SLOT_LEN
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_update_fd_pipelined(sha3_ctx_t *ctx, int fd, int tee_fd, uint32_t slots, size_t slot_len);
+
+/**
+ * @brief             Hashes the rest of a file descriptor
+ *
+ * @param mode        [in] hash mode
+ * @param fd          [in] open file descriptor
+ * @param output_data [out] pointer to output buffer
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_fd(sha3_hash_modes_t mode, int fd, uint8_t *output_data);
+
+/**
+ * @brief             Hashes a file
+ *
+ * @param mode        [in] hash mode
+ * @param path        [in] file name
+ * @param output_data [out] pointer to output buffer
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_file(sha3_hash_modes_t mode, const char *path, uint8_t *output_data);
+
 #ifdef  __cplusplus
 }
 #endif
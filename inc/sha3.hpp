@@ -0,0 +1,482 @@
+/**
+* @file  sha3.hpp
+* @brief Header-only C++17 interface with compile-time mode parameters
+*        and a constexpr Keccak
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __SHA3_HPP_
+#define __SHA3_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#if defined(__has_include)
+#if __has_include(<span>) && (__cplusplus >= 202002L)
+#include <span>
+#endif
+#endif
+
+#include "sha3.h"
+#include "keccak.h"
+
+namespace sha3 {
+
+namespace detail {
+
+/**
+ * Sponge parameters of a mode: rate and default output in bytes, domain
+ * padding byte, rounds and whether the mode is extendable output.
+ */
+template <sha3_hash_modes_t Mode> struct mode_traits;
+
+template <std::size_t Rate, std::size_t Digest, std::uint8_t Pad, std::uint32_t Rounds, bool Xof>
+struct mode_params
+{
+    static constexpr std::size_t   rate = Rate;
+    static constexpr std::size_t   digest_size = Digest;
+    static constexpr std::uint8_t  pad = Pad;
+    static constexpr std::uint32_t rounds = Rounds;
+    static constexpr bool          xof = Xof;
+};
+
+template <> struct mode_traits<SHA3_224>      : mode_params<144, SHA3_224_HASH_LEN, 0x06, KECCAK_ROUNDS, false> {};
+template <> struct mode_traits<SHA3_256>      : mode_params<136, SHA3_256_HASH_LEN, 0x06, KECCAK_ROUNDS, false> {};
+template <> struct mode_traits<SHA3_384>      : mode_params<104, SHA3_384_HASH_LEN, 0x06, KECCAK_ROUNDS, false> {};
+template <> struct mode_traits<SHA3_512>      : mode_params< 72, SHA3_512_HASH_LEN, 0x06, KECCAK_ROUNDS, false> {};
+template <> struct mode_traits<SHAKE128>      : mode_params<168, SHAKE128_HASH_LEN, 0x1F, KECCAK_ROUNDS, true> {};
+template <> struct mode_traits<SHAKE256>      : mode_params<136, SHAKE256_HASH_LEN, 0x1F, KECCAK_ROUNDS, true> {};
+template <> struct mode_traits<TURBOSHAKE128> : mode_params<168, SHAKE128_HASH_LEN, 0x1F, 12, true> {};
+template <> struct mode_traits<TURBOSHAKE256> : mode_params<136, SHAKE256_HASH_LEN, 0x1F, 12, true> {};
+
+inline std::uint64_t load64_le(const std::uint8_t *p) noexcept
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return  (std::uint64_t)p[0]        | ((std::uint64_t)p[1] << 8)  |
+           ((std::uint64_t)p[2] << 16) | ((std::uint64_t)p[3] << 24) |
+           ((std::uint64_t)p[4] << 32) | ((std::uint64_t)p[5] << 40) |
+           ((std::uint64_t)p[6] << 48) | ((std::uint64_t)p[7] << 56);
+#endif
+}
+
+inline void store64_le(std::uint8_t *p, std::uint64_t v) noexcept
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    std::memcpy(p, &v, sizeof(v));
+#else
+    for (int i = 0; i < 8; i++)
+    {
+        p[i] = (std::uint8_t)(v >> (8 * i));
+    }
+#endif
+}
+
+// Iota round constants, rho rotations and pi lane order (as src/keccak.c)
+constexpr std::uint64_t keccak_rc[KECCAK_ROUNDS] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+constexpr unsigned keccak_rotc[24] =
+{
+    1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
+    27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44
+};
+
+constexpr unsigned keccak_piln[24] =
+{
+    10, 7,  11, 17, 18, 3, 5,  16, 8,  21, 24, 4,
+    15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1
+};
+
+constexpr std::uint64_t rotl64(std::uint64_t x, unsigned y)
+{
+    return (x << y) | (x >> (64 - y));
+}
+
+} // namespace detail
+
+/**
+ * Keccak-p[1600, rounds] usable in constant expressions, the last
+ * 'rounds' rounds as keccak_fn() does.
+ */
+constexpr std::array<std::uint64_t, 25> keccak_p(std::array<std::uint64_t, 25> s,
+                                                 std::uint32_t rounds = KECCAK_ROUNDS)
+{
+    std::uint64_t bc[5] = {};
+    std::uint64_t t = 0;
+
+    for (std::uint32_t round = KECCAK_ROUNDS - rounds; round < KECCAK_ROUNDS; round++)
+    {
+        // theta
+        for (int i = 0; i < 5; i++)
+        {
+            bc[i] = s[i] ^ s[i + 5] ^ s[i + 10] ^ s[i + 15] ^ s[i + 20];
+        }
+
+        for (int i = 0; i < 5; i++)
+        {
+            t = bc[(i + 4) % 5] ^ detail::rotl64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5)
+            {
+                s[j + i] ^= t;
+            }
+        }
+
+        // rho and pi
+        t = s[1];
+        for (int i = 0; i < 24; i++)
+        {
+            unsigned j = detail::keccak_piln[i];
+            bc[0] = s[j];
+            s[j] = detail::rotl64(t, detail::keccak_rotc[i]);
+            t = bc[0];
+        }
+
+        // chi
+        for (int j = 0; j < 25; j += 5)
+        {
+            for (int i = 0; i < 5; i++)
+            {
+                bc[i] = s[j + i];
+            }
+
+            for (int i = 0; i < 5; i++)
+            {
+                s[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+
+        // iota
+        s[0] ^= detail::keccak_rc[round];
+    }
+
+    return s;
+}
+
+namespace detail {
+
+// Byte-wise sponge for constant expressions
+template <sha3_hash_modes_t Mode, std::size_t N, typename Byte>
+constexpr std::array<std::uint8_t, N> sponge(const Byte *data, std::size_t len, std::uint8_t pad)
+{
+    using traits = mode_traits<Mode>;
+    std::array<std::uint64_t, 25> s = {};
+    std::array<std::uint8_t, N> out = {};
+    std::size_t pos = 0;
+
+    for (std::size_t i = 0; i < len; i++)
+    {
+        s[pos / 8] ^= (std::uint64_t)(std::uint8_t)data[i] << (8 * (pos % 8));
+        if (++pos == traits::rate)
+        {
+            s = keccak_p(s, traits::rounds);
+            pos = 0;
+        }
+    }
+
+    s[pos / 8] ^= (std::uint64_t)pad << (8 * (pos % 8));
+    s[(traits::rate - 1) / 8] ^= (std::uint64_t)0x80 << (8 * ((traits::rate - 1) % 8));
+    s = keccak_p(s, traits::rounds);
+    pos = 0;
+
+    for (std::size_t i = 0; i < N; i++)
+    {
+        if (pos == traits::rate)
+        {
+            s = keccak_p(s, traits::rounds);
+            pos = 0;
+        }
+
+        out[i] = (std::uint8_t)(s[pos / 8] >> (8 * (pos % 8)));
+        pos++;
+    }
+
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * Digest evaluated by the compiler when the input is a constant, e.g.
+ *
+ *     constexpr auto d = sha3::digest<SHA3_256>("abc");
+ *
+ * N bytes of output, the mode's digest size by default (any length for
+ * SHAKE/TurboSHAKE).
+ */
+template <sha3_hash_modes_t Mode, std::size_t N = detail::mode_traits<Mode>::digest_size>
+constexpr std::array<std::uint8_t, N> digest(std::string_view data)
+{
+    static_assert(detail::mode_traits<Mode>::xof || (N <= detail::mode_traits<Mode>::digest_size),
+                  "fixed output modes give at most digest_size bytes");
+    return detail::sponge<Mode, N>(data.data(), data.size(), detail::mode_traits<Mode>::pad);
+}
+
+template <sha3_hash_modes_t Mode, std::size_t N = detail::mode_traits<Mode>::digest_size, std::size_t L>
+constexpr std::array<std::uint8_t, N> digest(const std::array<std::uint8_t, L> &data)
+{
+    static_assert(detail::mode_traits<Mode>::xof || (N <= detail::mode_traits<Mode>::digest_size),
+                  "fixed output modes give at most digest_size bytes");
+    return detail::sponge<Mode, N>(data.data(), L, detail::mode_traits<Mode>::pad);
+}
+
+/**
+ * First 8 digest bytes as a little-endian integer: a hash ID usable as
+ * a case label or a key of a precomputed table.
+ */
+template <sha3_hash_modes_t Mode = SHA3_256>
+constexpr std::uint64_t id64(std::string_view data)
+{
+    auto d = detail::sponge<Mode, 8>(data.data(), data.size(), detail::mode_traits<Mode>::pad);
+    std::uint64_t id = 0;
+
+    for (int i = 7; i >= 0; i--)
+    {
+        id = (id << 8) | d[i];
+    }
+
+    return id;
+}
+
+/**
+ * SHA3 / SHAKE / TurboSHAKE hasher with the mode fixed at compile time.
+ *
+ * Rate, digest size and rounds are constants, so the absorb and squeeze
+ * loops are unrolled for the mode and there is no mode switch per call.
+ * The state lives in the object, nothing is allocated. Uses the sponge
+ * kernel chosen by the KECCAK build switch (SHA3_KECCAK_* defines), build
+ * with the same defines as the library for the same kernel.
+ *
+ *     auto d = sha3::hasher<SHA3_256>().update("abc").finalize();
+ */
+template <sha3_hash_modes_t Mode>
+class hasher
+{
+    using traits = detail::mode_traits<Mode>;
+
+public:
+    static constexpr std::size_t   rate = traits::rate;
+    static constexpr std::size_t   digest_size = traits::digest_size;
+    static constexpr std::uint32_t rounds = traits::rounds;
+    static constexpr bool          xof = traits::xof;
+
+    using digest_type = std::array<std::uint8_t, digest_size>;
+
+    hasher() noexcept
+    {
+        reset();
+    }
+
+    /**
+     * TurboSHAKE with a domain byte other than the default 0x1F
+     */
+    explicit hasher(std::uint8_t domain) noexcept
+    {
+        static_assert(rounds != KECCAK_ROUNDS, "domain byte is for TurboSHAKE modes");
+        reset();
+        pad_ = domain;
+    }
+
+    /**
+     * Starts a new message, keeps the TurboSHAKE domain
+     */
+    void reset() noexcept
+    {
+        s_.fill(0);
+        buf_len_ = 0;
+    }
+
+    hasher &update(const void *data, std::size_t len) noexcept
+    {
+        const std::uint8_t *p = static_cast<const std::uint8_t *>(data);
+
+        // data may be null for an empty chunk (empty span, string_view)
+        if (len == 0)
+        {
+            return *this;
+        }
+
+        if (buf_len_ != 0)
+        {
+            std::size_t n = rate - buf_len_;
+
+            if (len < n)
+            {
+                std::memcpy(buf_.data() + buf_len_, p, len);
+                buf_len_ += len;
+                return *this;
+            }
+
+            std::memcpy(buf_.data() + buf_len_, p, n);
+            absorb_block(buf_.data());
+            p += n;
+            len -= n;
+            buf_len_ = 0;
+        }
+
+        for (; len >= rate; p += rate, len -= rate)
+        {
+            absorb_block(p);
+        }
+
+        std::memcpy(buf_.data(), p, len);
+        buf_len_ = len;
+
+        return *this;
+    }
+
+    hasher &update(std::string_view data) noexcept
+    {
+        return update(data.data(), data.size());
+    }
+
+#if defined(__cpp_lib_span)
+    hasher &update(std::span<const std::uint8_t> data) noexcept
+    {
+        return update(data.data(), data.size());
+    }
+
+    hasher &update(std::span<const std::byte> data) noexcept
+    {
+        return update(data.data(), data.size());
+    }
+#endif
+
+    /**
+     * Digest (default output length for SHAKE/TurboSHAKE). The hasher
+     * has to be reset() before the next message.
+     */
+    digest_type finalize() noexcept
+    {
+        digest_type out;
+
+        squeeze(out.data(), out.size());
+        return out;
+    }
+
+    /**
+     * N bytes of output of an extendable output mode
+     */
+    template <std::size_t N>
+    std::array<std::uint8_t, N> finalize() noexcept
+    {
+        static_assert(xof || (N <= digest_size), "fixed output modes give at most digest_size bytes");
+        std::array<std::uint8_t, N> out;
+
+        squeeze(out.data(), N);
+        return out;
+    }
+
+    /**
+     * One-shot digest of a buffer
+     */
+    static digest_type hash(const void *data, std::size_t len) noexcept
+    {
+        return hasher().update(data, len).finalize();
+    }
+
+    static digest_type hash(std::string_view data) noexcept
+    {
+        return hash(data.data(), data.size());
+    }
+
+private:
+    void absorb_block(const std::uint8_t *block) noexcept
+    {
+        for (std::size_t i = 0; i < rate / 8; i++)
+        {
+            s_[i] ^= KECCAK_LANE_IN(detail::load64_le(block + 8 * i));
+        }
+
+        KECCAK_PERMUTE(s_.data(), rounds);
+    }
+
+    void squeeze(std::uint8_t *out, std::size_t len) noexcept
+    {
+        std::uint8_t lane[8];
+        std::size_t n, i;
+
+        std::memset(buf_.data() + buf_len_, 0, rate - buf_len_);
+        buf_[buf_len_] ^= pad_;
+        buf_[rate - 1] ^= 0x80;
+        absorb_block(buf_.data());
+
+        for (;;)
+        {
+            n = (len < rate) ? len : rate;
+
+            for (i = 0; i + 8 <= n; i += 8)
+            {
+                detail::store64_le(out + i, KECCAK_LANE_OUT(s_[i / 8]));
+            }
+
+            if (i < n)
+            {
+                detail::store64_le(lane, KECCAK_LANE_OUT(s_[i / 8]));
+                std::memcpy(out + i, lane, n - i);
+            }
+
+            out += n;
+            len -= n;
+            if (0 == len)
+            {
+                break;
+            }
+
+            KECCAK_PERMUTE(s_.data(), rounds);
+        }
+    }
+
+    std::array<std::uint64_t, 25>   s_;
+    std::array<std::uint8_t, rate>  buf_;
+    std::size_t                     buf_len_;
+    std::uint8_t                    pad_ = traits::pad;
+};
+
+using sha3_224 = hasher<SHA3_224>;
+using sha3_256 = hasher<SHA3_256>;
+using sha3_384 = hasher<SHA3_384>;
+using sha3_512 = hasher<SHA3_512>;
+using shake128 = hasher<SHAKE128>;
+using shake256 = hasher<SHAKE256>;
+using turboshake128 = hasher<TURBOSHAKE128>;
+using turboshake256 = hasher<TURBOSHAKE256>;
+
+} // namespace sha3
+
+#endif // __SHA3_HPP_
@@ -0,0 +1,148 @@
+/**
+* @file  sha3_aead.h
+* @brief Keccak duplex authenticated encryption
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  04.01.2014
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __SHA3_AEAD_H_
+#define __SHA3_AEAD_H_
+
+#include <stdint.h>
+
+#include "sha3.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Duplex AEAD definitions.
+ */
+
+/** Key, nonce and tag limits (in bytes) */
+#define SHA3_AEAD_MIN_KEY_LEN   16
+#define SHA3_AEAD_MAX_KEY_LEN   64
+#define SHA3_AEAD_MAX_NONCE_LEN 32
+#define SHA3_AEAD_MIN_TAG_LEN   16
+#define SHA3_AEAD_MAX_TAG_LEN   64
+
+/** Default tag length (in bytes) */
+#define SHA3_AEAD_TAG_LEN       (256/8)
+
+typedef enum
+{
+	SHA3_AEAD_128 = 0,             // SHAKE128 rate and capacity, 24 rounds
+	SHA3_AEAD_256,                 // SHAKE256 rate and capacity, 24 rounds
+	SHA3_AEAD_TURBO128,            // TurboSHAKE128, 12 rounds
+	SHA3_AEAD_TURBO256             // TurboSHAKE256, 12 rounds
+} sha3_aead_mode_t;
+
+typedef enum
+{
+	SHA3_AEAD_OK = 0,
+	SHA3_AEAD_ERROR,
+	SHA3_AEAD_TAG_MISMATCH
+} sha3_aead_status_t;
+
+
+/**
+ * @brief             Encrypts and authenticates in a single pass
+ *
+ * Key and nonce go into the first duplex block, associated data and
+ * plaintext follow in blocks of rate - 1 bytes, each block costs one
+ * permutation that produces the keystream of the next one. The tag is
+ * squeezed after the last plaintext block. A nonce must never be used
+ * twice with the same key.
+ *
+ * @param mode        [in] AEAD mode
+ * @param key         [in] key, SHA3_AEAD_MIN_KEY_LEN..SHA3_AEAD_MAX_KEY_LEN bytes
+ * @param key_len     [in] key length in bytes
+ * @param nonce       [in] nonce, may be NULL if nonce_len is 0
+ * @param nonce_len   [in] nonce length in bytes, at most SHA3_AEAD_MAX_NONCE_LEN
+ * @param ad          [in] associated data, may be NULL if ad_len is 0
+ * @param ad_len      [in] associated data length in bytes
+ * @param input_data  [in] plaintext, may be NULL if len is 0
+ * @param len         [in] plaintext length in bytes
+ * @param output_data [out] ciphertext of len bytes, may be input_data
+ * @param tag         [out] tag
+ * @param tag_len     [in] tag length, SHA3_AEAD_MIN_TAG_LEN..SHA3_AEAD_MAX_TAG_LEN
+ *
+ * @return            status of operation
+ */
+sha3_aead_status_t SHA3_AEAD_ENCRYPT(sha3_aead_mode_t mode,
+                                     const uint8_t *key,
+                                     size_t key_len,
+                                     const uint8_t *nonce,
+                                     size_t nonce_len,
+                                     const uint8_t *ad,
+                                     size_t ad_len,
+                                     const uint8_t *input_data,
+                                     size_t len,
+                                     uint8_t *output_data,
+                                     uint8_t *tag,
+                                     size_t tag_len);
+
+/**
+ * @brief             Decrypts and verifies in a single pass
+ *
+ * On SHA3_AEAD_TAG_MISMATCH output_data is cleared, no unauthenticated
+ * plaintext is returned.
+ *
+ * @param mode        [in] AEAD mode
+ * @param key         [in] key
+ * @param key_len     [in] key length in bytes
+ * @param nonce       [in] nonce, may be NULL if nonce_len is 0
+ * @param nonce_len   [in] nonce length in bytes
+ * @param ad          [in] associated data, may be NULL if ad_len is 0
+ * @param ad_len      [in] associated data length in bytes
+ * @param input_data  [in] ciphertext, may be NULL if len is 0
+ * @param len         [in] ciphertext length in bytes
+ * @param tag         [in] tag to verify
+ * @param tag_len     [in] tag length in bytes
+ * @param output_data [out] plaintext of len bytes, may be input_data
+ *
+ * @return            status of operation
+ */
+sha3_aead_status_t SHA3_AEAD_DECRYPT(sha3_aead_mode_t mode,
+                                     const uint8_t *key,
+                                     size_t key_len,
+                                     const uint8_t *nonce,
+                                     size_t nonce_len,
+                                     const uint8_t *ad,
+                                     size_t ad_len,
+                                     const uint8_t *input_data,
+                                     size_t len,
+                                     const uint8_t *tag,
+                                     size_t tag_len,
+                                     uint8_t *output_data);
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+
+#endif // __SHA3_AEAD_H_
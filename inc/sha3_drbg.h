@@ -0,0 +1,140 @@
+/**
+* @file  sha3_drbg.h
+* @brief Keccak sponge deterministic random bit generator
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __SHA3_DRBG_H_
+#define __SHA3_DRBG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha3.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/** Least entropy input accepted by sha3_drbg_seed (in bytes) */
+#define SHA3_DRBG_SEED_MIN_LEN    32
+
+/** Output of a per-thread generator between reseeds from the OS (in bytes) */
+#define SHA3_DRBG_RESEED_INTERVAL ((uint64_t)1 << 32)
+
+/**
+ * Sponge DRBG.
+ *
+ * Seed material is absorbed into a SHAKE or TurboSHAKE sponge, every
+ * request squeezes straight into the caller's buffer and then forgets:
+ * the rate is zeroed and the state permuted, so a state captured later
+ * does not reveal earlier output. Not thread safe, one per thread.
+ */
+typedef struct sha3_drbg
+{
+    sha3_ctx_t ctx;
+    uint64_t   generated;                      // bytes since the last (re)seed
+    uint32_t   fork_gen;                       // per-thread instance only
+    uint8_t    seeded;
+} sha3_drbg_t;
+
+/**
+ * @brief             Instantiates a DRBG
+ *
+ * @param drbg        [in] DRBG to be seeded
+ * @param mode        [in] SHAKE128, SHAKE256, TURBOSHAKE128 or TURBOSHAKE256
+ * @param entropy     [in] entropy input, at least SHA3_DRBG_SEED_MIN_LEN bytes
+ * @param entropy_len [in] entropy input length in bytes
+ * @param pers        [in] personalization string, may be NULL if pers_len is 0
+ * @param pers_len    [in] personalization string length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_drbg_seed(sha3_drbg_t *drbg,
+                             sha3_hash_modes_t mode,
+                             const uint8_t *entropy,
+                             size_t entropy_len,
+                             const uint8_t *pers,
+                             size_t pers_len);
+
+/**
+ * @brief             Mixes fresh entropy into a seeded DRBG
+ *
+ * @param drbg        [in] DRBG
+ * @param entropy     [in] entropy input
+ * @param entropy_len [in] entropy input length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_drbg_reseed(sha3_drbg_t *drbg, const uint8_t *entropy, size_t entropy_len);
+
+/**
+ * @brief             Random bytes
+ *
+ * One request costs a permutation per rate block plus one to forget,
+ * ask for large blocks rather than many small ones. A request of 2n
+ * bytes does not return the same bytes as two requests of n.
+ *
+ * @param drbg        [in] seeded DRBG
+ * @param output_data [out] pointer to output buffer
+ * @param len         [in] number of bytes
+ * @param additional  [in] additional input, may be NULL if additional_len is 0
+ * @param additional_len [in] additional input length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_drbg_generate(sha3_drbg_t *drbg,
+                                 uint8_t *output_data,
+                                 size_t len,
+                                 const uint8_t *additional,
+                                 size_t additional_len);
+
+/**
+ * @brief             Clears a DRBG
+ *
+ * @param drbg        [in] DRBG
+ */
+void sha3_drbg_wipe(sha3_drbg_t *drbg);
+
+/**
+ * @brief             Random bytes from the calling thread's generator
+ *
+ * Every thread has its own TurboSHAKE128 DRBG, seeded from the OS on
+ * first use, after SHA3_DRBG_RESEED_INTERVAL bytes and in the child
+ * after fork(). No locks, no shared state: output scales with threads.
+ *
+ * @param output_data [out] pointer to output buffer
+ * @param len         [in] number of bytes
+ *
+ * @return            status of operation, SHA3_ERROR if the OS has no entropy
+ */
+sha3_status_t sha3_random(uint8_t *output_data, size_t len);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif // __SHA3_DRBG_H_
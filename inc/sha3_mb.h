@@ -0,0 +1,138 @@
+/**
+* @file  sha3_mb.h
+* @brief Multi-buffer job manager for mixed-length hashing requests
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __SHA3_MB_H_
+#define __SHA3_MB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha3.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Multi-buffer job manager.
+ *
+ * Jobs submitted from any thread are hashed by a manager thread that
+ * keeps every lane of the multi-lane Keccak kernel busy: as soon as one
+ * message is finished its lane takes the next queued job. A partly
+ * filled set of lanes waits at most timeout_us (counted from the oldest
+ * job in it) for more jobs before it is hashed anyway.
+ */
+typedef struct sha3_mb_mgr sha3_mb_mgr_t;
+
+typedef struct sha3_mb_job sha3_mb_job_t;
+
+/**
+ * Completion callback, runs on the manager thread.
+ */
+typedef void (*sha3_mb_cb_t)(sha3_mb_job_t *job);
+
+/**
+ * Hashing job. The caller owns the memory and keeps job, input and
+ * output alive until the job is completed.
+ */
+struct sha3_mb_job
+{
+    sha3_hash_modes_t mode;                    // SHA3_224 .. SHAKE256
+    const uint8_t    *input_data;
+    size_t            len;
+    uint8_t          *output_data;             // digest length of mode
+    sha3_mb_cb_t      callback;                // NULL: completion queue
+    void             *user_data;
+    sha3_status_t     status;                  // result, set on completion
+    sha3_mb_job_t    *next;                    // manager link / polled list
+    uint64_t          submit_ns;               // manager use
+};
+
+
+/**
+ * @brief             Starts a job manager
+ *
+ * @param timeout_us  [in] longest wait for lanes to fill, 0 to hash
+ *                    whatever is queued right away
+ *
+ * @return            manager or NULL on failure
+ */
+sha3_mb_mgr_t *sha3_mb_create(uint32_t timeout_us);
+
+/**
+ * @brief             Flushes all jobs and stops the manager
+ *
+ * Completed jobs still in the queue have to be polled before.
+ *
+ * @param mgr         [in] manager
+ */
+void sha3_mb_destroy(sha3_mb_mgr_t *mgr);
+
+/**
+ * @brief             Queues a job, may be called from any thread
+ *
+ * SHA3 modes and SHAKE modes with their default output length are
+ * supported. SHAKE256 outputs SHAKE256_HASH_LEN bytes.
+ *
+ * @param mgr         [in] manager
+ * @param job         [in] job to hash
+ *
+ * @return            status of operation, a job that is not queued is
+ *                    never completed
+ */
+sha3_status_t sha3_mb_submit(sha3_mb_mgr_t *mgr, sha3_mb_job_t *job);
+
+/**
+ * @brief             Hashes queued jobs without waiting for the lanes to fill
+ *
+ * Returns once every job submitted before the call is completed and its
+ * callback has returned. Must not be called from a callback.
+ *
+ * @param mgr         [in] manager
+ */
+void sha3_mb_flush(sha3_mb_mgr_t *mgr);
+
+/**
+ * @brief             Takes the completed jobs without a callback
+ *
+ * Lock free, the jobs come in completion order linked by job->next.
+ *
+ * @param mgr         [in] manager
+ *
+ * @return            list of completed jobs, NULL if there are none
+ */
+sha3_mb_job_t *sha3_mb_poll(sha3_mb_mgr_t *mgr);
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+
+#endif // __SHA3_MB_H_
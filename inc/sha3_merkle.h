@@ -0,0 +1,173 @@
+/**
+* @file  sha3_merkle.h
+* @brief Merkle tree over SHA3 with incremental leaf updates
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  04.01.2014
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __SHA3_MERKLE_H_
+#define __SHA3_MERKLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha3.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Merkle tree definitions.
+ *
+ * leaf = H(0x00 || data), node = H(0x01 || left || right). A node
+ * without a right sibling moves up a level unchanged.
+ */
+
+/** Most levels of a tree (leaves and root included) */
+#define SHA3_MERKLE_MAX_LEVELS 65
+
+/**
+ * Merkle tree.
+ *
+ * Nodes are stored level by level in one array: all leaf hashes first,
+ * then every level above them, the root last.
+ */
+typedef struct sha3_merkle
+{
+    sha3_hash_modes_t mode;                    // SHA3_224 .. SHA3_512
+    uint32_t          d;                       // node size in bytes
+    uint32_t          levels;
+    size_t            leaves;
+    size_t            count[SHA3_MERKLE_MAX_LEVELS];   // nodes of a level
+    size_t            offset[SHA3_MERKLE_MAX_LEVELS];  // first node of a level
+    uint8_t          *nodes;
+} sha3_merkle_t;
+
+
+/**
+ * @brief             Allocates a tree
+ *
+ * @param tree        [out] tree
+ * @param mode        [in] SHA3 hash mode
+ * @param leaves      [in] number of leaves, at least 1
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_merkle_init(sha3_merkle_t *tree, sha3_hash_modes_t mode, size_t leaves);
+
+/**
+ * @brief             Releases the nodes of a tree
+ *
+ * @param tree        [in] tree
+ */
+void sha3_merkle_free(sha3_merkle_t *tree);
+
+/**
+ * @brief             Hashes all leaves and levels
+ *
+ * Leaves and then the node pairs of every level are hashed by the
+ * multi-lane kernel on the worker pool.
+ *
+ * @param tree        [in/out] tree
+ * @param leaf_data   [in] array of tree->leaves pointers to leaf data
+ * @param leaf_len    [in] array of tree->leaves leaf lengths in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_merkle_build(sha3_merkle_t *tree,
+                                const uint8_t *const *leaf_data,
+                                const size_t *leaf_len);
+
+/**
+ * @brief             Replaces one leaf, only its path to the root is rehashed
+ *
+ * @param tree        [in/out] built tree
+ * @param index       [in] leaf index
+ * @param data        [in] new leaf data
+ * @param len         [in] new leaf length in bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_merkle_update(sha3_merkle_t *tree, size_t index, const uint8_t *data, size_t len);
+
+/**
+ * @brief             Copies the root
+ *
+ * @param tree        [in] built tree
+ * @param output_data [out] tree->d bytes
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_merkle_root(const sha3_merkle_t *tree, uint8_t *output_data);
+
+/**
+ * @brief             Inclusion proof of a leaf
+ *
+ * The proof is the sibling of every node on the path that has one,
+ * from the leaf level up, tree->d bytes each.
+ *
+ * @param tree        [in] built tree
+ * @param index       [in] leaf index
+ * @param proof       [out] up to (tree->levels - 1) * tree->d bytes
+ * @param proof_num   [out] number of siblings written
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_merkle_proof(const sha3_merkle_t *tree,
+                                size_t index,
+                                uint8_t *proof,
+                                uint32_t *proof_num);
+
+/**
+ * @brief             Checks an inclusion proof against a root
+ *
+ * @param mode        [in] SHA3 hash mode of the tree
+ * @param root        [in] expected root
+ * @param leaves      [in] number of leaves of the tree
+ * @param index       [in] leaf index
+ * @param data        [in] leaf data
+ * @param len         [in] leaf length in bytes
+ * @param proof       [in] siblings from sha3_merkle_proof
+ * @param proof_num   [in] number of siblings
+ *
+ * @return            SHA3_OK if the leaf is in the tree
+ */
+sha3_status_t sha3_merkle_verify(sha3_hash_modes_t mode,
+                                 const uint8_t *root,
+                                 size_t leaves,
+                                 size_t index,
+                                 const uint8_t *data,
+                                 size_t len,
+                                 const uint8_t *proof,
+                                 uint32_t proof_num);
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+
+#endif // __SHA3_MERKLE_H_
@@ -0,0 +1,133 @@
+/**
+* @file  sha3_stats.h
+* @brief Optional per-thread counters and timing hooks
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __SHA3_STATS_H_
+#define __SHA3_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha3.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Instrumentation definitions.
+ *
+ * Counting is compiled in only with SHA3_STATS defined (make STATS=1),
+ * otherwise the hot paths carry no trace of it and the functions below
+ * return SHA3_ERROR.
+ */
+
+/** Number of sha3_hash_modes_t values counted in calls[] */
+#define SHA3_STATS_MODES (TURBOSHAKE256 + 1)
+
+/**
+ * Counters of the calling thread.
+ */
+typedef struct sha3_stats
+{
+    uint64_t permutations;                     // single state Keccak-p calls
+    uint64_t lane_permutations;                // multi-lane kernel calls
+    uint64_t lanes_busy;                       // states of those calls carrying a message
+    uint64_t bytes_absorbed;
+    uint64_t bytes_squeezed;
+    uint64_t calls[SHA3_STATS_MODES];          // contexts, one-shots and batch messages per mode
+    uint64_t hmac_inner;                       // HMAC inner passes (messages started)
+    uint64_t hmac_outer;                       // HMAC outer passes (tags finished)
+} sha3_stats_t;
+
+/**
+ * Operations reported to the timing hooks.
+ */
+typedef enum
+{
+    SHA3_STATS_ABSORB = 0,                     // sha3_update
+    SHA3_STATS_SQUEEZE,                        // sha3_final, sha3_squeeze
+    SHA3_STATS_BATCH,                          // sha3_hash_many and friends, len is the message count
+    SHA3_STATS_BLOCK                           // SHA3_32, SHA3_64
+} sha3_stats_op_t;
+
+/**
+ * Hook event: operation, its input (NULL for squeezes) and a time stamp
+ * (TSC on x86, CLOCK_MONOTONIC ns elsewhere).
+ */
+typedef struct sha3_stats_event
+{
+    sha3_stats_op_t op;
+    const void     *data;
+    size_t          len;
+    uint64_t        tsc;
+} sha3_stats_event_t;
+
+/**
+ * Hook, runs on the hashing thread.
+ */
+typedef void (*sha3_stats_hook_t)(void *arg, const sha3_stats_event_t *event);
+
+
+/**
+ * @brief             Copies the counters of the calling thread
+ *
+ * @param stats       [out] counters
+ *
+ * @return            status of operation, SHA3_ERROR without SHA3_STATS
+ */
+sha3_status_t sha3_stats_snapshot(sha3_stats_t *stats);
+
+/**
+ * @brief             Clears the counters of the calling thread
+ *
+ * @return            status of operation, SHA3_ERROR without SHA3_STATS
+ */
+sha3_status_t sha3_stats_reset(void);
+
+/**
+ * @brief             Sets process wide begin/end hooks, NULL to remove
+ *
+ * Hooks are meant to be set up before hashing starts, e.g. to sum
+ * cycles per caller or to fingerprint inputs hashed twice.
+ *
+ * @param begin       [in] called before an operation
+ * @param end         [in] called after it
+ * @param arg         [in] hook argument
+ *
+ * @return            status of operation, SHA3_ERROR without SHA3_STATS
+ */
+sha3_status_t sha3_stats_set_hooks(sha3_stats_hook_t begin, sha3_stats_hook_t end, void *arg);
+
+
+#ifdef  __cplusplus
+}
+#endif
+
+
+#endif // __SHA3_STATS_H_
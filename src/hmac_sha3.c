@@ -30,69 +30,143 @@
 #include <string.h>
 
 #include "hmac_sha3.h"
+#include "sha3_internal.h"
 
 
 
-//-----------------------------------------------------------------------------
-hmac_sha3_status_t hmac_sha3_init(hmac_sha3_hash_mode_t mode,
-                                  hmac_sha3_ctx_t *ctx,
-                                  const uint8_t *key,
-                                  int key_len)
-{
-    int i;
-
-    if ( (NULL == ctx) || (NULL == key) )
-    {
-        return HMAC_SHA3_ERROR;
-    }
+// Messages per pass of hmac_sha3_verify_many
+#define HMAC_VERIFY_CHUNK 16
 
-    memset (ctx, 0, sizeof(hmac_sha3_ctx_t) );
 
+//-----------------------------------------------------------------------------
+static hmac_sha3_status_t hmac_sha3_sha_mode(hmac_sha3_hash_mode_t mode, sha3_hash_modes_t *sha_mode)
+{
     switch(mode)
     {
         case HMAC_SHA3_224:
-            ctx->sha_mode = SHA3_224;
-            ctx->blocksize = SHA3_224_HMAC_LEN;
+            *sha_mode = SHA3_224;
             break;
         case HMAC_SHA3_256:
-            ctx->sha_mode = SHA3_256;
-            ctx->blocksize = SHA3_256_HMAC_LEN;
+            *sha_mode = SHA3_256;
             break;
         case HMAC_SHA3_384:
-            ctx->sha_mode = SHA3_384;
-            ctx->blocksize = SHA3_384_HMAC_LEN;
+            *sha_mode = SHA3_384;
             break;
         case HMAC_SHA3_512:
-            ctx->sha_mode = SHA3_512;
-            ctx->blocksize = SHA3_512_HMAC_LEN;
+            *sha_mode = SHA3_512;
             break;
         default:
             return HMAC_SHA3_ERROR;
     }
 
+    return HMAC_SHA3_OK;
+}
+
+
+// K ^ ipad and K ^ opad blocks of blocksize bytes
+//-----------------------------------------------------------------------------
+static void hmac_sha3_pads(sha3_hash_modes_t sha_mode,
+                           const uint8_t *key,
+                           size_t key_len,
+                           size_t blocksize,
+                           size_t digest_len,
+                           uint8_t *ipad,
+                           uint8_t *opad)
+{
+    uint8_t key_hash[SHA3_512_HASH_LEN];
+    size_t i;
+
      // Step 1. If key is longer than blocksize  reset it to key = HASH(key)
-    if (key_len > ctx->blocksize)
+    if (key_len > blocksize)
     {
-        SHA3(ctx->sha_mode, key, key_len, (uint8_t*)key);
-        key_len = ctx->blocksize;
+        SHA3(sha_mode, key, key_len, key_hash);
+        key = key_hash;
+        key_len = digest_len;
     }
 
     // Step 2. Start out by storing key in pads
-    memset(ctx->ipad, 0, HMAC_MAX_KEY_LEN);
-    memset(ctx->opad, 0, HMAC_MAX_KEY_LEN);
+    memset(ipad, 0, blocksize);
+    memset(opad, 0, blocksize);
 
-    memcpy( ctx->ipad, key, key_len);
-    memcpy( ctx->opad, key, key_len);
+    memcpy(ipad, key, key_len);
+    memcpy(opad, key, key_len);
 
     // Step 3. XOR key with ipad and opad values
-    for (i = 0; i < HMAC_MAX_KEY_LEN; i++)
+    for (i = 0; i < blocksize; i++)
+    {
+        ipad[i] ^= IPAD;
+        opad[i] ^= OPAD;
+    }
+
+    memset(key_hash, 0, sizeof(key_hash));
+}
+
+
+// 1 if a and b are equal, the time depends on len only
+//-----------------------------------------------------------------------------
+static uint32_t hmac_sha3_equal(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    uint32_t diff = 0;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        diff |= a[i] ^ b[i];
+    }
+
+    return (diff - 1) >> 31;
+}
+
+
+//-----------------------------------------------------------------------------
+hmac_sha3_status_t hmac_sha3_init(hmac_sha3_hash_mode_t mode,
+                                  hmac_sha3_ctx_t *ctx,
+                                  const uint8_t *key,
+                                  size_t key_len)
+{
+    uint8_t ipad[HMAC_MAX_KEY_LEN];
+    uint8_t opad[HMAC_MAX_KEY_LEN];
+
+    if ( (NULL == ctx) || (NULL == key) )
+    {
+        return HMAC_SHA3_ERROR;
+    }
+
+    memset (ctx, 0, sizeof(hmac_sha3_ctx_t) );
+
+    if ( (HMAC_SHA3_OK != hmac_sha3_sha_mode(mode, &ctx->sha_mode)) ||
+         (SHA3_OK != sha3_init(ctx->sha_mode, &ctx->inner)) )
     {
-        ctx->ipad[i] ^= IPAD;
-        ctx->opad[i] ^= OPAD;
+        return HMAC_SHA3_ERROR;
+    }
+
+    // HMAC block size is the rate of the hash
+    ctx->blocksize = ctx->inner.bs;
+    ctx->outer = ctx->inner;
+
+    hmac_sha3_pads(ctx->sha_mode, key, key_len, ctx->blocksize, ctx->inner.d, ipad, opad);
+
+    // Step 4. Absorb both pads once, messages start from copies
+    sha3_update(&ctx->inner, ipad, ctx->blocksize);
+    sha3_update(&ctx->outer, opad, ctx->blocksize);
+
+    memset(ipad, 0, sizeof(ipad));
+    memset(opad, 0, sizeof(opad));
+
+    return hmac_sha3_reset(ctx);
+}
+
+
+//-----------------------------------------------------------------------------
+hmac_sha3_status_t hmac_sha3_reset(hmac_sha3_ctx_t *ctx)
+{
+    if ( (NULL == ctx) || (0 == ctx->blocksize) )
+    {
+        return HMAC_SHA3_ERROR;
     }
 
-    sha3_init(ctx->sha_mode, &ctx->ctx);
-    sha3_update(&ctx->ctx, ctx->ipad, HMAC_MAX_KEY_LEN);
+    ctx->ctx = ctx->inner;
+    SHA3_STATS_ADD(hmac_inner, 1);
 
     return HMAC_SHA3_OK;
 }
@@ -101,7 +175,7 @@ hmac_sha3_status_t hmac_sha3_init(hmac_sha3_hash_mode_t mode,
 //-----------------------------------------------------------------------------
 hmac_sha3_status_t hmac_sha3_update(hmac_sha3_ctx_t *ctx,
                                     const uint8_t *input_data,
-                                    uint32_t len)
+                                    size_t len)
 {
     if ( (NULL == ctx) || (NULL == input_data) )
     {
@@ -121,6 +195,7 @@ hmac_sha3_status_t hmac_sha3_update(hmac_sha3_ctx_t *ctx,
 hmac_sha3_status_t hmac_sha3_final(hmac_sha3_ctx_t *ctx, uint8_t *output_data)
 {
 
+    uint8_t inner_hash[SHA3_512_HASH_LEN];
     sha3_ctx_t out_ctx;
     sha3_status_t res = SHA3_ERROR;
 
@@ -129,14 +204,19 @@ hmac_sha3_status_t hmac_sha3_final(hmac_sha3_ctx_t *ctx, uint8_t *output_data)
         return HMAC_SHA3_ERROR;
     }
 
-    if ( SHA3_OK != sha3_final(&ctx->ctx, output_data) )
+    if ( SHA3_OK != sha3_final(&ctx->ctx, inner_hash) )
     {
         return HMAC_SHA3_ERROR;
     }
 
-    res = sha3_init(ctx->sha_mode , &out_ctx);
-    res = sha3_update(&out_ctx, ctx->opad, ctx->blocksize);
-    res = sha3_final(&out_ctx, output_data);
+    // H(K ^ opad || H(K ^ ipad || message)) from the precomputed outer state
+    out_ctx = ctx->outer;
+    SHA3_STATS_ADD(hmac_outer, 1);
+    res = sha3_update(&out_ctx, inner_hash, out_ctx.d);
+    if (SHA3_OK == res)
+    {
+        res = sha3_final(&out_ctx, output_data);
+    }
 
     if(SHA3_OK != res)
     {
@@ -147,12 +227,104 @@ hmac_sha3_status_t hmac_sha3_final(hmac_sha3_ctx_t *ctx, uint8_t *output_data)
 }
 
 
+//-----------------------------------------------------------------------------
+hmac_sha3_status_t hmac_sha3_verify_many(hmac_sha3_hash_mode_t mode,
+                                         const uint8_t *const *key,
+                                         const size_t *key_len,
+                                         const uint8_t *const *input_data,
+                                         const size_t *len,
+                                         const uint8_t *const *tag,
+                                         size_t tag_len,
+                                         uint8_t *result,
+                                         uint32_t num)
+{
+    uint8_t ipad[HMAC_VERIFY_CHUNK][HMAC_MAX_KEY_LEN];
+    uint8_t opad[HMAC_VERIFY_CHUNK][HMAC_MAX_KEY_LEN];
+    uint8_t inner[HMAC_VERIFY_CHUNK][SHA3_512_HASH_LEN];
+    uint8_t mac[HMAC_VERIFY_CHUNK][SHA3_512_HASH_LEN];
+    const uint8_t *head[HMAC_VERIFY_CHUNK];
+    const uint8_t *in[HMAC_VERIFY_CHUNK];
+    uint8_t *out[HMAC_VERIFY_CHUNK];
+    size_t in_len[HMAC_VERIFY_CHUNK];
+    sha3_hash_modes_t sha_mode;
+    sha3_ctx_t params;
+    hmac_sha3_status_t res = HMAC_SHA3_OK;
+    uint32_t base, n, i;
+
+    if ( (NULL == key) || (NULL == key_len) || (NULL == input_data) || (NULL == len) ||
+         (NULL == tag) || (NULL == result) || (0 == tag_len) ||
+         (HMAC_SHA3_OK != hmac_sha3_sha_mode(mode, &sha_mode)) ||
+         (SHA3_OK != sha3_init(sha_mode, &params)) || (tag_len > params.d) )
+    {
+        return HMAC_SHA3_ERROR;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        if ( (NULL == key[i]) || (NULL == tag[i]) || ( (NULL == input_data[i]) && (len[i] != 0) ) )
+        {
+            return HMAC_SHA3_ERROR;
+        }
+    }
+
+    memset(result, 0, (num + 7) / 8);
+
+    // Inner and outer hashes of HMAC_VERIFY_CHUNK messages at a time
+    // through the multi-lane kernel: K ^ ipad || m, then K ^ opad || inner
+    for (base = 0; (HMAC_SHA3_OK == res) && (base < num); base += n)
+    {
+        n = (num - base > HMAC_VERIFY_CHUNK) ? HMAC_VERIFY_CHUNK : num - base;
+
+        for (i = 0; i < n; i++)
+        {
+            hmac_sha3_pads(sha_mode, key[base + i], key_len[base + i], params.bs, params.d, ipad[i], opad[i]);
+            head[i] = ipad[i];
+            out[i] = inner[i];
+        }
+
+        if (SHA3_OK != sha3_hash_many_head(sha_mode, head, params.bs, input_data + base, len + base, out, n))
+        {
+            res = HMAC_SHA3_ERROR;
+            break;
+        }
+        SHA3_STATS_ADD(hmac_inner, n);
+
+        for (i = 0; i < n; i++)
+        {
+            head[i] = opad[i];
+            in[i] = inner[i];
+            in_len[i] = params.d;
+            out[i] = mac[i];
+        }
+
+        if (SHA3_OK != sha3_hash_many_head(sha_mode, head, params.bs, in, in_len, out, n))
+        {
+            res = HMAC_SHA3_ERROR;
+            break;
+        }
+        SHA3_STATS_ADD(hmac_outer, n);
+
+        for (i = 0; i < n; i++)
+        {
+            result[(base + i) / 8] |= (uint8_t)(hmac_sha3_equal(mac[i], tag[base + i], tag_len) << ((base + i) % 8));
+        }
+    }
+
+    memset(ipad, 0, sizeof(ipad));
+    memset(opad, 0, sizeof(opad));
+    memset(inner, 0, sizeof(inner));
+    memset(mac, 0, sizeof(mac));
+
+    return res;
+}
+
+
 //-----------------------------------------------------------------------------
 hmac_sha3_status_t HMAC_SHA3(hmac_sha3_hash_mode_t mode,
                              const uint8_t *input_data,
-                             uint32_t len,
+                             size_t len,
                              const uint8_t *key,
-                             int key_len,
+                             size_t key_len,
                              uint8_t *output_data)
 {
     hmac_sha3_status_t res = HMAC_SHA3_OK;
@@ -164,8 +336,14 @@ hmac_sha3_status_t HMAC_SHA3(hmac_sha3_hash_mode_t mode,
     }
 
     res = hmac_sha3_init(mode , &ctx, key, key_len);
-    res = hmac_sha3_update(&ctx, input_data, len);
-    res = hmac_sha3_final(&ctx, output_data);
+    if (HMAC_SHA3_OK == res)
+    {
+        res = hmac_sha3_update(&ctx, input_data, len);
+    }
+    if (HMAC_SHA3_OK == res)
+    {
+        res = hmac_sha3_final(&ctx, output_data);
+    }
 
     return res;
 }
@@ -0,0 +1,498 @@
+/**
+* @file  keccak.c
+* @brief Keccak-p[1600] permutation kernels
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "keccak.h"
+
+// pseudo random round constants
+const uint64_t keccak_rc[KECCAK_ROUNDS]={
+               0x0000000000000001,
+		       0x0000000000008082,
+		       0x800000000000808A,
+		       0x8000000080008000,
+		       0x000000000000808B,
+		       0x0000000080000001,
+		       0x8000000080008081,
+		       0x8000000000008009,
+		       0x000000000000008A,
+		       0x0000000000000088,
+		       0x0000000080008009,
+		       0x000000008000000A,
+		       0x000000008000808B,
+		       0x800000000000008B,
+		       0x8000000000008089,
+		       0x8000000000008003,
+		       0x8000000000008002,
+		       0x8000000000000080,
+		       0x000000000000800A,
+		       0x800000008000000A,
+		       0x8000000080008081,
+		       0x8000000000008080,
+		       0x0000000080000001,
+		       0x8000000080008008
+};
+
+
+//rotation offsets
+static const uint64_t keccakf_rotc[24] =
+{
+        1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
+        27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44,
+};
+
+static const uint64_t keccakf_piln[24] =
+{
+        10, 7,  11, 17, 18, 3, 5,  16, 8,  21, 24, 4,
+        15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1,
+};
+
+
+#define ROTL64(x, y)        (((x) << (y)) | ((x) >> (64 - (y))))
+
+// Keccak round function, applies the last 'rounds' rounds
+//------------------------------------------------
+void keccak_fn(uint64_t s[25], uint32_t rounds)
+{
+    register int i, j, round;
+    register uint64_t t;
+    uint64_t bc[5];
+
+    for(round = KECCAK_ROUNDS - rounds; round < KECCAK_ROUNDS; round++)
+    {
+            //Theta step
+            for(i = 0; i < 5; i++)
+            {
+                bc[i] = s[i] ^ s[i + 5] ^ s[i + 10] ^ s[i + 15] ^ s[i + 20];
+            }
+
+            for(i = 0; i < 5; i++)
+            {
+                t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
+                for(j = 0; j < 25; j += 5)
+                {
+                        s[j + i] ^= t;
+                }
+            }
+
+            //Rho and Pi steps
+            t = s[1];
+            for(i = 0; i < 24; i++)
+            {
+                j = keccakf_piln[i];
+                bc[0] = s[j];
+                s[j] = ROTL64(t, keccakf_rotc[i]);
+                t = bc[0];
+            }
+
+            //Chi step
+            for(j = 0; j < 25; j += 5)
+            {
+                for(i = 0; i < 5; i++)
+                {
+                    bc[i] = s[j + i];
+                }
+
+                for(i = 0; i < 5; i++)
+                {
+                    s[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+                }
+            }
+
+            //Iota step
+            s[0] ^= keccak_rc[round];
+    }
+}
+
+// Round constants in bit-interleaved form: even bits, odd bits
+static const uint32_t keccak_rc_interleaved[KECCAK_ROUNDS][2] =
+{
+        { 0x00000001, 0x00000000 },
+        { 0x00000000, 0x00000089 },
+        { 0x00000000, 0x8000008B },
+        { 0x00000000, 0x80008080 },
+        { 0x00000001, 0x0000008B },
+        { 0x00000001, 0x00008000 },
+        { 0x00000001, 0x80008088 },
+        { 0x00000001, 0x80000082 },
+        { 0x00000000, 0x0000000B },
+        { 0x00000000, 0x0000000A },
+        { 0x00000001, 0x00008082 },
+        { 0x00000000, 0x00008003 },
+        { 0x00000001, 0x0000808B },
+        { 0x00000001, 0x8000000B },
+        { 0x00000001, 0x8000008A },
+        { 0x00000001, 0x80000081 },
+        { 0x00000000, 0x80000081 },
+        { 0x00000000, 0x80000008 },
+        { 0x00000000, 0x00000083 },
+        { 0x00000000, 0x80008003 },
+        { 0x00000001, 0x80008088 },
+        { 0x00000000, 0x80000088 },
+        { 0x00000001, 0x00008000 },
+        { 0x00000000, 0x80008082 },
+};
+
+// y has to be 0..31
+#define ROTL32(x, y)        (((x) << (y)) | ((x) >> ((32 - (y)) & 31)))
+
+// Keccak round function on 32-bit halves: e[] holds the even, o[] the
+// odd bits of every lane. Rotating a lane by 2q rotates both halves by
+// q, rotating by 2q + 1 also swaps them.
+//------------------------------------------------
+void keccak_fn_interleaved(uint64_t s[25], uint32_t rounds)
+{
+    uint32_t e[25], o[25];
+    uint32_t be[5], bo[5];
+    uint32_t te, to, r;
+    int i, j, round;
+
+    for(i = 0; i < 25; i++)
+    {
+        e[i] = (uint32_t)s[i];
+        o[i] = (uint32_t)(s[i] >> 32);
+    }
+
+    for(round = KECCAK_ROUNDS - rounds; round < KECCAK_ROUNDS; round++)
+    {
+            //Theta step
+            for(i = 0; i < 5; i++)
+            {
+                be[i] = e[i] ^ e[i + 5] ^ e[i + 10] ^ e[i + 15] ^ e[i + 20];
+                bo[i] = o[i] ^ o[i + 5] ^ o[i + 10] ^ o[i + 15] ^ o[i + 20];
+            }
+
+            for(i = 0; i < 5; i++)
+            {
+                te = be[(i + 4) % 5] ^ ROTL32(bo[(i + 1) % 5], 1);
+                to = bo[(i + 4) % 5] ^ be[(i + 1) % 5];
+                for(j = 0; j < 25; j += 5)
+                {
+                        e[j + i] ^= te;
+                        o[j + i] ^= to;
+                }
+            }
+
+            //Rho and Pi steps
+            te = e[1];
+            to = o[1];
+            for(i = 0; i < 24; i++)
+            {
+                j = keccakf_piln[i];
+                r = (uint32_t)keccakf_rotc[i];
+                be[0] = e[j];
+                bo[0] = o[j];
+                if (r & 1)
+                {
+                    e[j] = ROTL32(to, (r + 1) / 2);
+                    o[j] = ROTL32(te, r / 2);
+                }
+                else
+                {
+                    e[j] = ROTL32(te, r / 2);
+                    o[j] = ROTL32(to, r / 2);
+                }
+                te = be[0];
+                to = bo[0];
+            }
+
+            //Chi step
+            for(j = 0; j < 25; j += 5)
+            {
+                for(i = 0; i < 5; i++)
+                {
+                    be[i] = e[j + i];
+                    bo[i] = o[j + i];
+                }
+
+                for(i = 0; i < 5; i++)
+                {
+                    e[j + i] ^= (~be[(i + 1) % 5]) & be[(i + 2) % 5];
+                    o[j + i] ^= (~bo[(i + 1) % 5]) & bo[(i + 2) % 5];
+                }
+            }
+
+            //Iota step
+            e[0] ^= keccak_rc_interleaved[round][0];
+            o[0] ^= keccak_rc_interleaved[round][1];
+    }
+
+    for(i = 0; i < 25; i++)
+    {
+        s[i] = (uint64_t)e[i] | ((uint64_t)o[i] << 32);
+    }
+}
+
+// Lanes kept complemented by the unrolled kernel (lane complementing
+// transform, "bebigokimisa"): Abe, Abi, Ago, Aki, Ami, Asa.
+#define KECCAK_COMPLEMENT_LANES(s) \
+    do { \
+        (s)[1]  = ~(s)[1]; \
+        (s)[2]  = ~(s)[2]; \
+        (s)[8]  = ~(s)[8]; \
+        (s)[12] = ~(s)[12]; \
+        (s)[17] = ~(s)[17]; \
+        (s)[20] = ~(s)[20]; \
+    } while (0)
+
+// One round from state A into state E. With the lane complementing
+// transform chi needs a single NOT per plane.
+#define KECCAK_ROUND(A, E, rc) \
+    Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa; \
+    Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se; \
+    Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si; \
+    Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so; \
+    Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su; \
+    Da = Cu ^ ROTL64(Ce, 1); \
+    De = Ca ^ ROTL64(Ci, 1); \
+    Di = Ce ^ ROTL64(Co, 1); \
+    Do = Ci ^ ROTL64(Cu, 1); \
+    Du = Co ^ ROTL64(Ca, 1); \
+    \
+    Ba = A##ba ^ Da; \
+    Be = ROTL64(A##ge ^ De, 44); \
+    Bi = ROTL64(A##ki ^ Di, 43); \
+    Bo = ROTL64(A##mo ^ Do, 21); \
+    Bu = ROTL64(A##su ^ Du, 14); \
+    E##ba = Ba ^ ( Be |  Bi) ^ (rc); \
+    E##be = Be ^ (~Bi |  Bo); \
+    E##bi = Bi ^ ( Bo &  Bu); \
+    E##bo = Bo ^ ( Bu |  Ba); \
+    E##bu = Bu ^ ( Ba &  Be); \
+    \
+    Ba = ROTL64(A##bo ^ Do, 28); \
+    Be = ROTL64(A##gu ^ Du, 20); \
+    Bi = ROTL64(A##ka ^ Da, 3); \
+    Bo = ROTL64(A##me ^ De, 45); \
+    Bu = ROTL64(A##si ^ Di, 61); \
+    E##ga = Ba ^ ( Be |  Bi); \
+    E##ge = Be ^ ( Bi &  Bo); \
+    E##gi = Bi ^ ( Bo | ~Bu); \
+    E##go = Bo ^ ( Bu |  Ba); \
+    E##gu = Bu ^ ( Ba &  Be); \
+    \
+    Ba = ROTL64(A##be ^ De, 1); \
+    Be = ROTL64(A##gi ^ Di, 6); \
+    Bi = ROTL64(A##ko ^ Do, 25); \
+    Bo = ROTL64(A##mu ^ Du, 8); \
+    Bu = ROTL64(A##sa ^ Da, 18); \
+    E##ka =  Ba ^ ( Be |  Bi); \
+    E##ke =  Be ^ ( Bi &  Bo); \
+    E##ki =  Bi ^ (~Bo &  Bu); \
+    E##ko = ~Bo ^ ( Bu |  Ba); \
+    E##ku =  Bu ^ ( Ba &  Be); \
+    \
+    Ba = ROTL64(A##bu ^ Du, 27); \
+    Be = ROTL64(A##ga ^ Da, 36); \
+    Bi = ROTL64(A##ke ^ De, 10); \
+    Bo = ROTL64(A##mi ^ Di, 15); \
+    Bu = ROTL64(A##so ^ Do, 56); \
+    E##ma =  Ba ^ ( Be &  Bi); \
+    E##me =  Be ^ ( Bi |  Bo); \
+    E##mi =  Bi ^ (~Bo |  Bu); \
+    E##mo = ~Bo ^ ( Bu &  Ba); \
+    E##mu =  Bu ^ ( Ba |  Be); \
+    \
+    Ba = ROTL64(A##bi ^ Di, 62); \
+    Be = ROTL64(A##go ^ Do, 55); \
+    Bi = ROTL64(A##ku ^ Du, 39); \
+    Bo = ROTL64(A##ma ^ Da, 41); \
+    Bu = ROTL64(A##se ^ De, 2); \
+    E##sa =  Ba ^ (~Be &  Bi); \
+    E##se = ~Be ^ ( Bi |  Bo); \
+    E##si =  Bi ^ ( Bo &  Bu); \
+    E##so =  Bo ^ ( Bu |  Ba); \
+    E##su =  Bu ^ ( Ba &  Be);
+
+// Unrolled Keccak round function, applies the last 'rounds' rounds
+//------------------------------------------------
+void keccak_fn_unrolled(uint64_t s[25], uint32_t rounds)
+{
+    uint64_t Aba, Abe, Abi, Abo, Abu;
+    uint64_t Aga, Age, Agi, Ago, Agu;
+    uint64_t Aka, Ake, Aki, Ako, Aku;
+    uint64_t Ama, Ame, Ami, Amo, Amu;
+    uint64_t Asa, Ase, Asi, Aso, Asu;
+    uint64_t Eba, Ebe, Ebi, Ebo, Ebu;
+    uint64_t Ega, Ege, Egi, Ego, Egu;
+    uint64_t Eka, Eke, Eki, Eko, Eku;
+    uint64_t Ema, Eme, Emi, Emo, Emu;
+    uint64_t Esa, Ese, Esi, Eso, Esu;
+    uint64_t Ba, Be, Bi, Bo, Bu;
+    uint64_t Ca, Ce, Ci, Co, Cu;
+    uint64_t Da, De, Di, Do, Du;
+    uint32_t round;
+
+    KECCAK_COMPLEMENT_LANES(s);
+
+    Aba = s[0];  Abe = s[1];  Abi = s[2];  Abo = s[3];  Abu = s[4];
+    Aga = s[5];  Age = s[6];  Agi = s[7];  Ago = s[8];  Agu = s[9];
+    Aka = s[10]; Ake = s[11]; Aki = s[12]; Ako = s[13]; Aku = s[14];
+    Ama = s[15]; Ame = s[16]; Ami = s[17]; Amo = s[18]; Amu = s[19];
+    Asa = s[20]; Ase = s[21]; Asi = s[22]; Aso = s[23]; Asu = s[24];
+
+    for(round = KECCAK_ROUNDS - rounds; round < KECCAK_ROUNDS; round += 2)
+    {
+        KECCAK_ROUND(A, E, keccak_rc[round])
+        KECCAK_ROUND(E, A, keccak_rc[round + 1])
+    }
+
+    s[0]  = Aba; s[1]  = Abe; s[2]  = Abi; s[3]  = Abo; s[4]  = Abu;
+    s[5]  = Aga; s[6]  = Age; s[7]  = Agi; s[8]  = Ago; s[9]  = Agu;
+    s[10] = Aka; s[11] = Ake; s[12] = Aki; s[13] = Ako; s[14] = Aku;
+    s[15] = Ama; s[16] = Ame; s[17] = Ami; s[18] = Amo; s[19] = Amu;
+    s[20] = Asa; s[21] = Ase; s[22] = Asi; s[23] = Aso; s[24] = Asu;
+
+    KECCAK_COMPLEMENT_LANES(s);
+}
+
+// Portable 4-way round function
+//------------------------------------------------
+void keccak_fn_x4(uint64_t s[25 * 4], uint32_t rounds)
+{
+    uint64_t t[25];
+    int i, k;
+
+    for(k = 0; k < 4; k++)
+    {
+        for(i = 0; i < 25; i++)
+        {
+            t[i] = KECCAK_LANE_IN(s[4 * i + k]);
+        }
+
+        KECCAK_PERMUTE(t, rounds);
+
+        for(i = 0; i < 25; i++)
+        {
+            s[4 * i + k] = KECCAK_LANE_OUT(t[i]);
+        }
+    }
+}
+
+// Multi-lane backend dispatch
+//------------------------------------------------
+static int keccak_always_supported(void)
+{
+    return 1;
+}
+
+#ifdef KECCAK_HAVE_AVX2
+static int keccak_avx2_supported(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#ifdef KECCAK_HAVE_AVX512
+static int keccak_avx512_supported(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+}
+#endif
+
+// fastest first
+static const keccak_impl_t keccak_impls[] =
+{
+#ifdef KECCAK_HAVE_AVX512
+    { "avx512",  8, keccak_fn_x8_avx512, keccak_avx512_supported },
+#endif
+#ifdef KECCAK_HAVE_AVX2
+    { "avx2",    4, keccak_fn_x4_avx2,   keccak_avx2_supported },
+#endif
+    { "generic", 4, keccak_fn_x4,        keccak_always_supported },
+};
+
+#define KECCAK_IMPLS_NUM (sizeof(keccak_impls) / sizeof(keccak_impls[0]))
+
+static const keccak_impl_t *keccak_impl = NULL;
+
+//------------------------------------------------
+static const keccak_impl_t *keccak_find_impl(const char *name)
+{
+    uint32_t i;
+
+    for(i = 0; i < KECCAK_IMPLS_NUM; i++)
+    {
+        if ( ( (NULL == name) || (0 == strcmp(name, keccak_impls[i].name)) ) &&
+             keccak_impls[i].supported() )
+        {
+            return &keccak_impls[i];
+        }
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------
+const keccak_impl_t *keccak_select_impl(const char *name)
+{
+    const keccak_impl_t *impl = keccak_find_impl(name);
+
+    if (impl != NULL)
+    {
+        __atomic_store_n(&keccak_impl, impl, __ATOMIC_RELEASE);
+    }
+
+    return impl;
+}
+
+//------------------------------------------------
+const keccak_impl_t *keccak_get_impl(void)
+{
+    const keccak_impl_t *impl = __atomic_load_n(&keccak_impl, __ATOMIC_ACQUIRE);
+    const keccak_impl_t *expected = NULL;
+    const char *env;
+
+    if (impl != NULL)
+    {
+        return impl;
+    }
+
+    // First use. Racing threads compute the same answer, an explicit
+    // keccak_select_impl() in between wins.
+    env = getenv(KECCAK_IMPL_ENV);
+    impl = (env != NULL) ? keccak_find_impl(env) : NULL;
+    if (NULL == impl)
+    {
+        impl = keccak_find_impl(NULL);
+    }
+
+    if (!__atomic_compare_exchange_n(&keccak_impl, &expected, impl, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        impl = expected;
+    }
+
+    return impl;
+}
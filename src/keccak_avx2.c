@@ -0,0 +1,162 @@
+/**
+* @file  keccak_avx2.c
+* @brief AVX2 4-way Keccak-p[1600] permutation kernel
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "keccak.h"
+
+#ifdef KECCAK_HAVE_AVX2
+
+#include <immintrin.h>
+
+#define KECCAK_AVX2 __attribute__((target("avx2")))
+
+#define XOR4(a, b)          _mm256_xor_si256((a), (b))
+#define ANDNOT4(a, b)       _mm256_andnot_si256((a), (b))   // ~a & b
+
+// 64-bit rotation of every lane, byte multiples go through vpshufb
+//------------------------------------------------
+static inline KECCAK_AVX2 __m256i rotl64x4(__m256i x, int n)
+{
+    if (8 == n)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(
+                    14, 13, 12, 11, 10, 9, 8, 15, 6, 5, 4, 3, 2, 1, 0, 7,
+                    14, 13, 12, 11, 10, 9, 8, 15, 6, 5, 4, 3, 2, 1, 0, 7));
+    }
+
+    if (56 == n)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(
+                    8, 15, 14, 13, 12, 11, 10, 9, 0, 7, 6, 5, 4, 3, 2, 1,
+                    8, 15, 14, 13, 12, 11, 10, 9, 0, 7, 6, 5, 4, 3, 2, 1));
+    }
+
+    return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n));
+}
+
+// Chi over one plane
+#define CHI4(E, p, Ba, Be, Bi, Bo, Bu) \
+    E##p##a = XOR4(Ba, ANDNOT4(Be, Bi)); \
+    E##p##e = XOR4(Be, ANDNOT4(Bi, Bo)); \
+    E##p##i = XOR4(Bi, ANDNOT4(Bo, Bu)); \
+    E##p##o = XOR4(Bo, ANDNOT4(Bu, Ba)); \
+    E##p##u = XOR4(Bu, ANDNOT4(Ba, Be));
+
+// One round from state A into state E
+#define KECCAK_ROUND4(A, E, rc) \
+    Ca = XOR4(XOR4(XOR4(A##ba, A##ga), XOR4(A##ka, A##ma)), A##sa); \
+    Ce = XOR4(XOR4(XOR4(A##be, A##ge), XOR4(A##ke, A##me)), A##se); \
+    Ci = XOR4(XOR4(XOR4(A##bi, A##gi), XOR4(A##ki, A##mi)), A##si); \
+    Co = XOR4(XOR4(XOR4(A##bo, A##go), XOR4(A##ko, A##mo)), A##so); \
+    Cu = XOR4(XOR4(XOR4(A##bu, A##gu), XOR4(A##ku, A##mu)), A##su); \
+    Da = XOR4(Cu, rotl64x4(Ce, 1)); \
+    De = XOR4(Ca, rotl64x4(Ci, 1)); \
+    Di = XOR4(Ce, rotl64x4(Co, 1)); \
+    Do = XOR4(Ci, rotl64x4(Cu, 1)); \
+    Du = XOR4(Co, rotl64x4(Ca, 1)); \
+    \
+    Ba = XOR4(A##ba, Da); \
+    Be = rotl64x4(XOR4(A##ge, De), 44); \
+    Bi = rotl64x4(XOR4(A##ki, Di), 43); \
+    Bo = rotl64x4(XOR4(A##mo, Do), 21); \
+    Bu = rotl64x4(XOR4(A##su, Du), 14); \
+    CHI4(E, b, Ba, Be, Bi, Bo, Bu) \
+    E##ba = XOR4(E##ba, _mm256_set1_epi64x((long long)(rc))); \
+    \
+    Ba = rotl64x4(XOR4(A##bo, Do), 28); \
+    Be = rotl64x4(XOR4(A##gu, Du), 20); \
+    Bi = rotl64x4(XOR4(A##ka, Da), 3); \
+    Bo = rotl64x4(XOR4(A##me, De), 45); \
+    Bu = rotl64x4(XOR4(A##si, Di), 61); \
+    CHI4(E, g, Ba, Be, Bi, Bo, Bu) \
+    \
+    Ba = rotl64x4(XOR4(A##be, De), 1); \
+    Be = rotl64x4(XOR4(A##gi, Di), 6); \
+    Bi = rotl64x4(XOR4(A##ko, Do), 25); \
+    Bo = rotl64x4(XOR4(A##mu, Du), 8); \
+    Bu = rotl64x4(XOR4(A##sa, Da), 18); \
+    CHI4(E, k, Ba, Be, Bi, Bo, Bu) \
+    \
+    Ba = rotl64x4(XOR4(A##bu, Du), 27); \
+    Be = rotl64x4(XOR4(A##ga, Da), 36); \
+    Bi = rotl64x4(XOR4(A##ke, De), 10); \
+    Bo = rotl64x4(XOR4(A##mi, Di), 15); \
+    Bu = rotl64x4(XOR4(A##so, Do), 56); \
+    CHI4(E, m, Ba, Be, Bi, Bo, Bu) \
+    \
+    Ba = rotl64x4(XOR4(A##bi, Di), 62); \
+    Be = rotl64x4(XOR4(A##go, Do), 55); \
+    Bi = rotl64x4(XOR4(A##ku, Du), 39); \
+    Bo = rotl64x4(XOR4(A##ma, Da), 41); \
+    Bu = rotl64x4(XOR4(A##se, De), 2); \
+    CHI4(E, s, Ba, Be, Bi, Bo, Bu)
+
+#define LOAD4(i)            _mm256_loadu_si256((const __m256i *)(s + 4 * (i)))
+#define STORE4(i, v)        _mm256_storeu_si256((__m256i *)(s + 4 * (i)), (v))
+
+// AVX2 4-way round function, applies the last 'rounds' rounds
+//------------------------------------------------
+KECCAK_AVX2 void keccak_fn_x4_avx2(uint64_t s[25 * 4], uint32_t rounds)
+{
+    __m256i Aba, Abe, Abi, Abo, Abu;
+    __m256i Aga, Age, Agi, Ago, Agu;
+    __m256i Aka, Ake, Aki, Ako, Aku;
+    __m256i Ama, Ame, Ami, Amo, Amu;
+    __m256i Asa, Ase, Asi, Aso, Asu;
+    __m256i Eba, Ebe, Ebi, Ebo, Ebu;
+    __m256i Ega, Ege, Egi, Ego, Egu;
+    __m256i Eka, Eke, Eki, Eko, Eku;
+    __m256i Ema, Eme, Emi, Emo, Emu;
+    __m256i Esa, Ese, Esi, Eso, Esu;
+    __m256i Ba, Be, Bi, Bo, Bu;
+    __m256i Ca, Ce, Ci, Co, Cu;
+    __m256i Da, De, Di, Do, Du;
+    uint32_t round;
+
+    Aba = LOAD4(0);  Abe = LOAD4(1);  Abi = LOAD4(2);  Abo = LOAD4(3);  Abu = LOAD4(4);
+    Aga = LOAD4(5);  Age = LOAD4(6);  Agi = LOAD4(7);  Ago = LOAD4(8);  Agu = LOAD4(9);
+    Aka = LOAD4(10); Ake = LOAD4(11); Aki = LOAD4(12); Ako = LOAD4(13); Aku = LOAD4(14);
+    Ama = LOAD4(15); Ame = LOAD4(16); Ami = LOAD4(17); Amo = LOAD4(18); Amu = LOAD4(19);
+    Asa = LOAD4(20); Ase = LOAD4(21); Asi = LOAD4(22); Aso = LOAD4(23); Asu = LOAD4(24);
+
+    for(round = KECCAK_ROUNDS - rounds; round < KECCAK_ROUNDS; round += 2)
+    {
+        KECCAK_ROUND4(A, E, keccak_rc[round])
+        KECCAK_ROUND4(E, A, keccak_rc[round + 1])
+    }
+
+    STORE4(0, Aba);  STORE4(1, Abe);  STORE4(2, Abi);  STORE4(3, Abo);  STORE4(4, Abu);
+    STORE4(5, Aga);  STORE4(6, Age);  STORE4(7, Agi);  STORE4(8, Ago);  STORE4(9, Agu);
+    STORE4(10, Aka); STORE4(11, Ake); STORE4(12, Aki); STORE4(13, Ako); STORE4(14, Aku);
+    STORE4(15, Ama); STORE4(16, Ame); STORE4(17, Ami); STORE4(18, Amo); STORE4(19, Amu);
+    STORE4(20, Asa); STORE4(21, Ase); STORE4(22, Asi); STORE4(23, Aso); STORE4(24, Asu);
+}
+
+#endif // KECCAK_HAVE_AVX2
@@ -0,0 +1,143 @@
+/**
+* @file  keccak_avx512.c
+* @brief AVX-512 8-way Keccak-p[1600] permutation kernel
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "keccak.h"
+
+#ifdef KECCAK_HAVE_AVX512
+
+#include <immintrin.h>
+
+#define KECCAK_AVX512 __attribute__((target("avx512f")))
+
+#define XOR8(a, b)          _mm512_xor_si512((a), (b))
+#define XOR8_3(a, b, c)     _mm512_ternarylogic_epi64((a), (b), (c), 0x96)  // a ^ b ^ c
+#define CHI8(a, b, c)       _mm512_ternarylogic_epi64((a), (b), (c), 0xD2)  // a ^ (~b & c)
+#define ROL8(x, n)          _mm512_rol_epi64((x), (n))
+
+// Chi over one plane
+#define CHI8_PLANE(E, p, Ba, Be, Bi, Bo, Bu) \
+    E##p##a = CHI8(Ba, Be, Bi); \
+    E##p##e = CHI8(Be, Bi, Bo); \
+    E##p##i = CHI8(Bi, Bo, Bu); \
+    E##p##o = CHI8(Bo, Bu, Ba); \
+    E##p##u = CHI8(Bu, Ba, Be);
+
+// One round from state A into state E
+#define KECCAK_ROUND8(A, E, rc) \
+    Ca = XOR8_3(XOR8_3(A##ba, A##ga, A##ka), A##ma, A##sa); \
+    Ce = XOR8_3(XOR8_3(A##be, A##ge, A##ke), A##me, A##se); \
+    Ci = XOR8_3(XOR8_3(A##bi, A##gi, A##ki), A##mi, A##si); \
+    Co = XOR8_3(XOR8_3(A##bo, A##go, A##ko), A##mo, A##so); \
+    Cu = XOR8_3(XOR8_3(A##bu, A##gu, A##ku), A##mu, A##su); \
+    Da = XOR8(Cu, ROL8(Ce, 1)); \
+    De = XOR8(Ca, ROL8(Ci, 1)); \
+    Di = XOR8(Ce, ROL8(Co, 1)); \
+    Do = XOR8(Ci, ROL8(Cu, 1)); \
+    Du = XOR8(Co, ROL8(Ca, 1)); \
+    \
+    Ba = XOR8(A##ba, Da); \
+    Be = ROL8(XOR8(A##ge, De), 44); \
+    Bi = ROL8(XOR8(A##ki, Di), 43); \
+    Bo = ROL8(XOR8(A##mo, Do), 21); \
+    Bu = ROL8(XOR8(A##su, Du), 14); \
+    CHI8_PLANE(E, b, Ba, Be, Bi, Bo, Bu) \
+    E##ba = XOR8(E##ba, _mm512_set1_epi64((long long)(rc))); \
+    \
+    Ba = ROL8(XOR8(A##bo, Do), 28); \
+    Be = ROL8(XOR8(A##gu, Du), 20); \
+    Bi = ROL8(XOR8(A##ka, Da), 3); \
+    Bo = ROL8(XOR8(A##me, De), 45); \
+    Bu = ROL8(XOR8(A##si, Di), 61); \
+    CHI8_PLANE(E, g, Ba, Be, Bi, Bo, Bu) \
+    \
+    Ba = ROL8(XOR8(A##be, De), 1); \
+    Be = ROL8(XOR8(A##gi, Di), 6); \
+    Bi = ROL8(XOR8(A##ko, Do), 25); \
+    Bo = ROL8(XOR8(A##mu, Du), 8); \
+    Bu = ROL8(XOR8(A##sa, Da), 18); \
+    CHI8_PLANE(E, k, Ba, Be, Bi, Bo, Bu) \
+    \
+    Ba = ROL8(XOR8(A##bu, Du), 27); \
+    Be = ROL8(XOR8(A##ga, Da), 36); \
+    Bi = ROL8(XOR8(A##ke, De), 10); \
+    Bo = ROL8(XOR8(A##mi, Di), 15); \
+    Bu = ROL8(XOR8(A##so, Do), 56); \
+    CHI8_PLANE(E, m, Ba, Be, Bi, Bo, Bu) \
+    \
+    Ba = ROL8(XOR8(A##bi, Di), 62); \
+    Be = ROL8(XOR8(A##go, Do), 55); \
+    Bi = ROL8(XOR8(A##ku, Du), 39); \
+    Bo = ROL8(XOR8(A##ma, Da), 41); \
+    Bu = ROL8(XOR8(A##se, De), 2); \
+    CHI8_PLANE(E, s, Ba, Be, Bi, Bo, Bu)
+
+#define LOAD8(i)            _mm512_loadu_si512((const void *)(s + 8 * (i)))
+#define STORE8(i, v)        _mm512_storeu_si512((void *)(s + 8 * (i)), (v))
+
+// AVX-512 8-way round function, applies the last 'rounds' rounds
+//------------------------------------------------
+KECCAK_AVX512 void keccak_fn_x8_avx512(uint64_t s[25 * 8], uint32_t rounds)
+{
+    __m512i Aba, Abe, Abi, Abo, Abu;
+    __m512i Aga, Age, Agi, Ago, Agu;
+    __m512i Aka, Ake, Aki, Ako, Aku;
+    __m512i Ama, Ame, Ami, Amo, Amu;
+    __m512i Asa, Ase, Asi, Aso, Asu;
+    __m512i Eba, Ebe, Ebi, Ebo, Ebu;
+    __m512i Ega, Ege, Egi, Ego, Egu;
+    __m512i Eka, Eke, Eki, Eko, Eku;
+    __m512i Ema, Eme, Emi, Emo, Emu;
+    __m512i Esa, Ese, Esi, Eso, Esu;
+    __m512i Ba, Be, Bi, Bo, Bu;
+    __m512i Ca, Ce, Ci, Co, Cu;
+    __m512i Da, De, Di, Do, Du;
+    uint32_t round;
+
+    Aba = LOAD8(0);  Abe = LOAD8(1);  Abi = LOAD8(2);  Abo = LOAD8(3);  Abu = LOAD8(4);
+    Aga = LOAD8(5);  Age = LOAD8(6);  Agi = LOAD8(7);  Ago = LOAD8(8);  Agu = LOAD8(9);
+    Aka = LOAD8(10); Ake = LOAD8(11); Aki = LOAD8(12); Ako = LOAD8(13); Aku = LOAD8(14);
+    Ama = LOAD8(15); Ame = LOAD8(16); Ami = LOAD8(17); Amo = LOAD8(18); Amu = LOAD8(19);
+    Asa = LOAD8(20); Ase = LOAD8(21); Asi = LOAD8(22); Aso = LOAD8(23); Asu = LOAD8(24);
+
+    for(round = KECCAK_ROUNDS - rounds; round < KECCAK_ROUNDS; round += 2)
+    {
+        KECCAK_ROUND8(A, E, keccak_rc[round])
+        KECCAK_ROUND8(E, A, keccak_rc[round + 1])
+    }
+
+    STORE8(0, Aba);  STORE8(1, Abe);  STORE8(2, Abi);  STORE8(3, Abo);  STORE8(4, Abu);
+    STORE8(5, Aga);  STORE8(6, Age);  STORE8(7, Agi);  STORE8(8, Ago);  STORE8(9, Agu);
+    STORE8(10, Aka); STORE8(11, Ake); STORE8(12, Aki); STORE8(13, Ako); STORE8(14, Aku);
+    STORE8(15, Ama); STORE8(16, Ame); STORE8(17, Ami); STORE8(18, Amo); STORE8(19, Amu);
+    STORE8(20, Asa); STORE8(21, Ase); STORE8(22, Asi); STORE8(23, Aso); STORE8(24, Asu);
+}
+
+#endif // KECCAK_HAVE_AVX512
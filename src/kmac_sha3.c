@@ -0,0 +1,149 @@
+/**
+* @file  kmac_sha3.c
+* @brief KMAC (SP 800-185) module implementation
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  03.01.2014
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string.h>
+
+#include "kmac_sha3.h"
+
+static const uint8_t kmac_name[] = { 'K', 'M', 'A', 'C' };
+
+
+//-----------------------------------------------------------------------------
+kmac_sha3_status_t kmac_sha3_init(kmac_sha3_mode_t mode,
+                                  kmac_sha3_ctx_t *ctx,
+                                  const uint8_t *key,
+                                  size_t key_len,
+                                  const uint8_t *custom,
+                                  size_t custom_len)
+{
+    sha3_hash_modes_t sha_mode;
+
+    if ( (NULL == ctx) || (NULL == key) )
+    {
+        return KMAC_SHA3_ERROR;
+    }
+
+    switch(mode)
+    {
+        case KMAC_SHA3_128:
+            sha_mode = SHAKE128;
+            break;
+        case KMAC_SHA3_256:
+            sha_mode = SHAKE256;
+            break;
+        default:
+            return KMAC_SHA3_ERROR;
+    }
+
+    // cSHAKE(bytepad(encode_string(K), rate) || X || right_encode(L), L, "KMAC", S)
+    if ( (SHA3_OK != sha3_cshake_init(sha_mode, &ctx->ctx, kmac_name, sizeof(kmac_name), custom, custom_len)) ||
+         (SHA3_OK != sha3_update_bytepad(&ctx->ctx, &key, &key_len, 1)) )
+    {
+        return KMAC_SHA3_ERROR;
+    }
+
+    return KMAC_SHA3_OK;
+}
+
+
+//-----------------------------------------------------------------------------
+kmac_sha3_status_t kmac_sha3_update(kmac_sha3_ctx_t *ctx,
+                                    const uint8_t *input_data,
+                                    size_t len)
+{
+    if ( (NULL == ctx) || (NULL == input_data) )
+    {
+        return KMAC_SHA3_ERROR;
+    }
+
+    if ( SHA3_OK == sha3_update(&ctx->ctx, input_data, len) )
+    {
+        return KMAC_SHA3_OK;
+    }
+
+    return KMAC_SHA3_ERROR;
+}
+
+
+//-----------------------------------------------------------------------------
+kmac_sha3_status_t kmac_sha3_final(kmac_sha3_ctx_t *ctx,
+                                   uint8_t *output_data,
+                                   size_t output_len)
+{
+    uint8_t enc[SHA3_ENCODE_MAX_LEN];
+    uint32_t n;
+
+    if ( (NULL == ctx) || (NULL == output_data) )
+    {
+        return KMAC_SHA3_ERROR;
+    }
+
+    n = sha3_right_encode((uint64_t)output_len * 8, enc);
+
+    if ( (SHA3_OK != sha3_update(&ctx->ctx, enc, n)) ||
+         (SHA3_OK != sha3_squeeze(&ctx->ctx, output_data, output_len)) )
+    {
+        return KMAC_SHA3_ERROR;
+    }
+
+    return KMAC_SHA3_OK;
+}
+
+
+//-----------------------------------------------------------------------------
+kmac_sha3_status_t KMAC_SHA3(kmac_sha3_mode_t mode,
+                             const uint8_t *input_data,
+                             size_t len,
+                             const uint8_t *key,
+                             size_t key_len,
+                             const uint8_t *custom,
+                             size_t custom_len,
+                             uint8_t *output_data,
+                             size_t output_len)
+{
+    kmac_sha3_status_t res = KMAC_SHA3_OK;
+    kmac_sha3_ctx_t ctx;
+
+    if ( (input_data == NULL) || (output_data == NULL) || (key == NULL) )
+    {
+        return KMAC_SHA3_ERROR;
+    }
+
+    res = kmac_sha3_init(mode, &ctx, key, key_len, custom, custom_len);
+    if (KMAC_SHA3_OK == res)
+    {
+        res = kmac_sha3_update(&ctx, input_data, len);
+    }
+    if (KMAC_SHA3_OK == res)
+    {
+        res = kmac_sha3_final(&ctx, output_data, output_len);
+    }
+
+    return res;
+}
@@ -28,190 +28,1369 @@
 */
 
 
+#include <stddef.h>
 #include <stdint.h>
 #include <inttypes.h>
 #include <string.h>
 
 #include "sha3.h"
+#include "sha3_internal.h"
+#include "keccak.h"
 
 // TODO: define all magic here
 #define KECCAK_VECTOR_LEN 5
 
-// pseudo random round constants
-static const uint64_t RC[24]={
-               0x0000000000000001,
-		       0x0000000000008082,
-		       0x800000000000808A,
-		       0x8000000080008000,
-		       0x000000000000808B,
-		       0x0000000080000001,
-		       0x8000000080008081,
-		       0x8000000000008009,
-		       0x000000000000008A,
-		       0x0000000000000088,
-		       0x0000000080008009,
-		       0x000000008000000A,
-		       0x000000008000808B,
-		       0x800000000000008B,
-		       0x8000000000008089,
-		       0x8000000000008003,
-		       0x8000000000008002,
-		       0x8000000000000080,
-		       0x000000000000800A,
-		       0x800000008000000A,
-		       0x8000000080008081,
-		       0x8000000000008080,
-		       0x0000000080000001,
-		       0x8000000080008008
-};
-
-
-//rotation offsets
-static const uint64_t keccakf_rotc[24] =
-{
-        1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
-        27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44,
-};
-
-static const uint64_t keccakf_piln[24] =
-{
-        10, 7,  11, 17, 18, 3, 5,  16, 8,  21, 24, 4,
-        15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1,
-};
-
-
-#define ROTL64(x, y)        (((x) << (y)) | ((x) >> (64 - (y))))
-
-// Keccak round function
-//------------------------------------------------
-static void keccak_fn(uint64_t s[25], uint32_t rounds)
-{
-    register int i, j, round;
-    register uint64_t t;
-    uint64_t bc[5];
-
-    for(round = 0; round < rounds; round++)
-    {
-            //Theta step
-            for(i = 0; i < 5; i++)
-            {
-                bc[i] = s[i] ^ s[i + 5] ^ s[i + 10] ^ s[i + 15] ^ s[i + 20];
-            }
+// Domain separation bits followed by the first pad10*1 bit:
+// SHA3 (01), SHAKE (1111), cSHAKE (00)
+#define SHA3_DOMAIN_PAD   0x06
+#define SHAKE_DOMAIN_PAD  0x1F
+#define CSHAKE_DOMAIN_PAD 0x04
+#define SHA3_PAD_LAST     0x80
 
-            for(i = 0; i < 5; i++)
-            {
-                t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
-                for(j = 0; j < 25; j += 5)
-                {
-                        s[j + i] ^= t;
-                }
-            }
+// TurboSHAKE / KangarooTwelve: Keccak-p[1600, 12]
+#define TURBOSHAKE_ROUNDS   12
+#define TURBOSHAKE_DOMAIN_PAD 0x1F
 
-            //Rho and Pi steps
-            t = s[1];
-            for(i = 0; i < 24; i++)
-            {
-                j = keccakf_piln[i];
-                bc[0] = s[j];
-                s[j] = ROTL64(t, keccakf_rotc[i]);
-                t = bc[0];
-            }
+// sha3_ctx_t flags
+#define SHA3_FLAG_XOF       0x01    // mode allows sha3_squeeze
+#define SHA3_FLAG_SQUEEZING 0x02    // padded, buf_len counts squeezed bytes
+#define SHA3_FLAG_DUPLEX    0x04    // duplex object, only sha3_duplex_* apply
 
-            //Chi step
-            for(j = 0; j < 25; j += 5)
-            {
-                for(i = 0; i < 5; i++)
-                {
-                    bc[i] = s[j + i];
-                }
+// Little-endian lane load/store
+//-------------------------------------------------------
+static inline uint64_t load64_le(const uint8_t *p)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return  (uint64_t)p[0]        | ((uint64_t)p[1] << 8)  |
+           ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+           ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+#endif
+}
 
-                for(i = 0; i < 5; i++)
-                {
-                    s[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
-                }
-            }
+static inline void store64_le(uint8_t *p, uint64_t v)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    memcpy(p, &v, sizeof(v));
+#else
+    int i;
+    for(i = 0; i < 8; i++)
+    {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+#endif
+}
+
+// XOR one rate block into the state lane by lane and permute
+//-------------------------------------------------------
+static void sha3_absorb_block(uint64_t s[25], const uint8_t *block, uint32_t lanes, uint32_t rounds)
+{
+    uint32_t i;
+
+    for(i = 0; i < lanes; i++)
+    {
+        s[i] ^= KECCAK_LANE_IN(load64_le(block + 8 * i));
+    }
+
+    KECCAK_PERMUTE(s, rounds);
+    SHA3_STATS_ADD(permutations, 1);
+}
+
+// Apply domain bits and pad10*1 over a block holding len bytes
+//-------------------------------------------------------
+static void sha3_pad_block(uint8_t *block, uint32_t len, uint32_t bs, uint8_t pad)
+{
+    memset(block + len, 0, bs - len);
+    block[len] ^= pad;
+    block[bs - 1] ^= SHA3_PAD_LAST;
+}
+
+// Store d bytes of lanes s[0], s[stride], s[2 * stride], ...
+//-------------------------------------------------------
+static void sha3_store_lanes(uint8_t *output_data, const uint64_t *s, uint32_t stride, uint32_t d)
+{
+    uint32_t i;
+    uint8_t lane[8];
+
+    for(i = 0; i + 8 <= d; i += 8)
+    {
+        store64_le(output_data + i, s[(i / 8) * stride]);
+    }
+
+    if (i < d)
+    {
+        store64_le(lane, s[(i / 8) * stride]);
+        memcpy(output_data + i, lane, d - i);
+    }
+}
+
+// Store d bytes of a sponge state, lanes converted from the kernel layout
+//-------------------------------------------------------
+static void sha3_store_state(uint8_t *output_data, const uint64_t s[25], uint32_t d)
+{
+    uint32_t i;
+    uint8_t lane[8];
+
+    for(i = 0; i + 8 <= d; i += 8)
+    {
+        store64_le(output_data + i, KECCAK_LANE_OUT(s[i / 8]));
+    }
 
-            //Iota step
-            s[0] ^= RC[round];
+    if (i < d)
+    {
+        store64_le(lane, KECCAK_LANE_OUT(s[i / 8]));
+        memcpy(output_data + i, lane, d - i);
     }
 }
 
 //-------------------------------------------------------
-static sha3_status_t sha3_sponge_absorb(sha3_ctx_t *ctx, const uint8_t * input_data, uint32_t len)
+static sha3_status_t sha3_sponge_absorb(sha3_ctx_t *ctx, const uint8_t * input_data, size_t len)
 {
-    //TODO
+    uint32_t lanes;
+    size_t n;
+
+    if ( (NULL == ctx) || ( (NULL == input_data) && (len != 0) ) ||
+         (ctx->flags & SHA3_FLAG_SQUEEZING) )
+    {
+        return SHA3_ERROR;
+    }
+
+    lanes = ctx->bs / 8;
+    SHA3_STATS_ADD(bytes_absorbed, len);
+
+    // Complete the block left over from the previous call first
+    if (ctx->buf_len != 0)
+    {
+        n = ctx->bs - ctx->buf_len;
+        if (n > len)
+        {
+            n = len;
+        }
+
+        if (n != 0)
+        {
+            memcpy(ctx->buf + ctx->buf_len, input_data, n);
+        }
+        ctx->buf_len += (uint8_t)n;
+        input_data += n;
+        len -= n;
+
+        if (ctx->buf_len < ctx->bs)
+        {
+            return SHA3_OK;
+        }
+
+        sha3_absorb_block(ctx->s, ctx->buf, lanes, ctx->rounds);
+        ctx->buf_len = 0;
+    }
+
+    // Full blocks go straight from the caller's buffer into the state
+    while (len >= ctx->bs)
+    {
+        sha3_absorb_block(ctx->s, input_data, lanes, ctx->rounds);
+        input_data += ctx->bs;
+        len -= ctx->bs;
+    }
+
+    // Keep the tail until more data or the final call arrives
+    if (len != 0)
+    {
+        memcpy(ctx->buf, input_data, len);
+        ctx->buf_len = (uint8_t)len;
+    }
+
     return SHA3_OK;
 }
 
+// Pad the buffered tail and switch the sponge to squeezing
+//-------------------------------------------------------
+static void sha3_sponge_pad(sha3_ctx_t *ctx)
+{
+    sha3_pad_block(ctx->buf, ctx->buf_len, ctx->bs, ctx->pad);
+    sha3_absorb_block(ctx->s, ctx->buf, ctx->bs / 8, ctx->rounds);
+    ctx->buf_len = 0;
+    ctx->flags |= SHA3_FLAG_SQUEEZING;
+}
+
+// Squeeze any number of bytes, the state is permuted only once the
+// whole rate of the previous permutation has been handed out.
+//-------------------------------------------------------
+static void sha3_sponge_xof(sha3_ctx_t *ctx, uint8_t *output_data, size_t len)
+{
+    size_t n, i;
+
+    if (!(ctx->flags & SHA3_FLAG_SQUEEZING))
+    {
+        sha3_sponge_pad(ctx);
+    }
+
+    SHA3_STATS_ADD(bytes_squeezed, len);
+
+    while (len != 0)
+    {
+        if (ctx->buf_len == ctx->bs)
+        {
+            KECCAK_PERMUTE(ctx->s, ctx->rounds);
+            SHA3_STATS_ADD(permutations, 1);
+            ctx->buf_len = 0;
+        }
+
+        // whole blocks are stored lane by lane
+        if ( (0 == ctx->buf_len) && (len >= ctx->bs) )
+        {
+            sha3_store_state(output_data, ctx->s, ctx->bs);
+            ctx->buf_len = ctx->bs;
+            output_data += ctx->bs;
+            len -= ctx->bs;
+            continue;
+        }
+
+        n = ctx->bs - ctx->buf_len;
+        if (n > len)
+        {
+            n = len;
+        }
+
+        for(i = 0; i < n; i++)
+        {
+            output_data[i] = (uint8_t)(KECCAK_LANE_OUT(ctx->s[(ctx->buf_len + i) / 8]) >> (8 * ((ctx->buf_len + i) % 8)));
+        }
+
+        ctx->buf_len += (uint8_t)n;
+        output_data += n;
+        len -= n;
+    }
+}
+
 //-------------------------------------------------------
 static sha3_status_t sha3_sponge_squeeze(sha3_ctx_t *ctx, uint8_t *output_data)
 {
-    //TODO
+    if ( (NULL == ctx) || (NULL == output_data) )
+    {
+        return SHA3_ERROR;
+    }
+
+    if (ctx->flags & SHA3_FLAG_XOF)
+    {
+        sha3_sponge_xof(ctx, output_data, ctx->d);
+        return SHA3_OK;
+    }
+
+    if (ctx->flags & SHA3_FLAG_SQUEEZING)
+    {
+        return SHA3_ERROR;
+    }
+
+    sha3_sponge_pad(ctx);
+
+    // Digest is always shorter than the rate, one squeeze is enough
+    sha3_store_state(output_data, ctx->s, ctx->d);
+    SHA3_STATS_ADD(bytes_squeezed, ctx->d);
+
     return SHA3_OK;
 }
 
+// Rate, capacity and digest length in bits/bits/bytes, the domain
+// padding byte and the number of rounds for a mode
 //-------------------------------------------------------
-sha3_status_t sha3_init(sha3_hash_modes_t mode, sha3_ctx_t *ctx)
+static sha3_status_t sha3_mode_params(sha3_hash_modes_t mode,
+                                      uint16_t *r,
+                                      uint16_t *c,
+                                      uint16_t *d,
+                                      uint8_t *pad,
+                                      uint8_t *rounds)
 {
-    memset(ctx, 0, sizeof(sha3_ctx_t) );
-    
+    *pad = SHA3_DOMAIN_PAD;
+    *rounds = KECCAK_ROUNDS;
+
     switch(mode)
     {
     	case SHA3_224: 
-    		ctx->r = 1152; 
-    		ctx->c = 448; 
-    		ctx->d = 28;
+    		*r = 1152; 
+    		*c = 448; 
+    		*d = 28;
     		break;
     	case SHA3_256: 
-    		ctx->r = 1088; 
-    		ctx->c = 512; 
-    		ctx->d = 32;
+    		*r = 1088; 
+    		*c = 512; 
+    		*d = 32;
     		break;
     	case SHA3_384:
-    		ctx->r = 832; 
-    		ctx->c = 768; 
-    		ctx->d = 48;
+    		*r = 832; 
+    		*c = 768; 
+    		*d = 48;
     		break;
     	case SHA3_512: 
-    		ctx->r = 576; 
-    		ctx->c = 1024; 
-    		ctx->d = 64;
+    		*r = 576; 
+    		*c = 1024; 
+    		*d = 64;
+    		break;
+    	case SHAKE128:
+    		*r = 1344;
+    		*c = 256;
+    		*d = 32;
+    		*pad = SHAKE_DOMAIN_PAD;
+    		break;
+    	case SHAKE256:
+    		*r = 1088;
+    		*c = 512;
+    		*d = 64;
+    		*pad = SHAKE_DOMAIN_PAD;
+    		break;
+    	case TURBOSHAKE128:
+    		*r = 1344;
+    		*c = 256;
+    		*d = 32;
+    		*pad = TURBOSHAKE_DOMAIN_PAD;
+    		*rounds = TURBOSHAKE_ROUNDS;
+    		break;
+    	case TURBOSHAKE256:
+    		*r = 1088;
+    		*c = 512;
+    		*d = 64;
+    		*pad = TURBOSHAKE_DOMAIN_PAD;
+    		*rounds = TURBOSHAKE_ROUNDS;
     		break;
     	default:
     		return SHA3_ERROR;
     }
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_init(sha3_hash_modes_t mode, sha3_ctx_t *ctx)
+{
+    if (NULL == ctx)
+    {
+        return SHA3_ERROR;
+    }
+
+    memset(ctx, 0, sizeof(sha3_ctx_t) );
+    
+    if (SHA3_OK != sha3_mode_params(mode, &ctx->r, &ctx->c, &ctx->d, &ctx->pad, &ctx->rounds))
+    {
+        return SHA3_ERROR;
+    }
     
     ctx->bs = (uint8_t)(ctx->r / 8);
+    SHA3_STATS_CALLS(mode, 1);
+
+    if ( (SHAKE128 == mode) || (SHAKE256 == mode) ||
+         (TURBOSHAKE128 == mode) || (TURBOSHAKE256 == mode) )
+    {
+        ctx->flags = SHA3_FLAG_XOF;
+    }
         
     return SHA3_OK;
 }
 
 //-------------------------------------------------------
-sha3_status_t sha3_update(sha3_ctx_t *ctx, const uint8_t * input_data, uint32_t len)
+sha3_status_t sha3_turboshake_init(sha3_hash_modes_t mode, sha3_ctx_t *ctx, uint8_t domain)
+{
+    if ( ( (TURBOSHAKE128 != mode) && (TURBOSHAKE256 != mode) ) ||
+         (domain < 0x01) || (domain > 0x7F) )
+    {
+        return SHA3_ERROR;
+    }
+
+    if (SHA3_OK != sha3_init(mode, ctx))
+    {
+        return SHA3_ERROR;
+    }
+
+    ctx->pad = domain;
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_update(sha3_ctx_t *ctx, const uint8_t * input_data, size_t len)
 {
-    return sha3_sponge_absorb(ctx, input_data, len);
+    sha3_status_t res;
+
+    SHA3_STATS_BEGIN(SHA3_STATS_ABSORB, input_data, len);
+    res = sha3_sponge_absorb(ctx, input_data, len);
+    SHA3_STATS_END(SHA3_STATS_ABSORB, input_data, len);
+
+    return res;
 }
 
 //-------------------------------------------------------
 sha3_status_t sha3_final(sha3_ctx_t *ctx, uint8_t * output_data)
 {
-    return sha3_sponge_squeeze(ctx, output_data);
+    sha3_status_t res;
+
+    SHA3_STATS_BEGIN(SHA3_STATS_SQUEEZE, NULL, 0);
+    res = sha3_sponge_squeeze(ctx, output_data);
+    SHA3_STATS_END(SHA3_STATS_SQUEEZE, NULL, 0);
+
+    return res;
 }
 
 //-------------------------------------------------------
-sha3_status_t SHA3(sha3_hash_modes_t mode, const uint8_t *input_data, uint32_t len, uint8_t *output_data)
+sha3_status_t sha3_final_keep(const sha3_ctx_t *ctx, uint8_t *output_data)
 {
-	sha3_status_t res = SHA3_OK; 
-	sha3_ctx_t ctx;
-	
-	if ( (input_data == NULL) || (output_data == NULL) )
-	{
-		return SHA3_ERROR;
-	}
-	
-	res = sha3_init(mode ,&ctx);
-	res = sha3_update(&ctx, input_data, len);
-	res = sha3_final(&ctx, output_data);
-	
-	return res;
+    sha3_status_t res;
+    sha3_ctx_t tmp;
+
+    if (SHA3_OK != sha3_ctx_clone(&tmp, ctx))
+    {
+        return SHA3_ERROR;
+    }
+
+    SHA3_STATS_BEGIN(SHA3_STATS_SQUEEZE, NULL, 0);
+    res = sha3_sponge_squeeze(&tmp, output_data);
+    SHA3_STATS_END(SHA3_STATS_SQUEEZE, NULL, 0);
+
+    return res;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_ctx_clone(sha3_ctx_t *dst, const sha3_ctx_t *src)
+{
+    if ( (NULL == dst) || (NULL == src) )
+    {
+        return SHA3_ERROR;
+    }
+
+    if (dst == src)
+    {
+        return SHA3_OK;
+    }
+
+    // the buffer is mostly stale, only its pending bytes are needed
+    memcpy(dst->s, src->s, sizeof(src->s));
+    memcpy(&dst->r, &src->r, sizeof(sha3_ctx_t) - offsetof(sha3_ctx_t, r));
+    if (!(src->flags & SHA3_FLAG_SQUEEZING))
+    {
+        memcpy(dst->buf, src->buf, src->buf_len);
+    }
+
+    return SHA3_OK;
+}
+
+// Prefix state cache
+//-------------------------------------------------------
+void sha3_prefix_cache_init(sha3_prefix_cache_t *cache)
+{
+    uint32_t i;
+
+    if (NULL == cache)
+    {
+        return;
+    }
+
+    for(i = 0; i < SHA3_PREFIX_CACHE_SLOTS; i++)
+    {
+        cache->entry[i].stamp = 0;
+    }
+    cache->clock = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+// Next use stamp. Entries are dropped when the clock wraps, so 0 keeps
+// meaning a free slot.
+//-------------------------------------------------------
+static uint32_t sha3_prefix_tick(sha3_prefix_cache_t *cache)
+{
+    uint32_t i;
+
+    if (0 == ++cache->clock)
+    {
+        for(i = 0; i < SHA3_PREFIX_CACHE_SLOTS; i++)
+        {
+            cache->entry[i].stamp = 0;
+        }
+        cache->clock = 1;
+    }
+
+    return cache->clock;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_prefix_ctx(sha3_prefix_cache_t *cache,
+                              sha3_hash_modes_t mode,
+                              const uint8_t *prefix,
+                              size_t len,
+                              sha3_ctx_t *ctx)
+{
+    sha3_prefix_entry_t *e;
+    sha3_prefix_entry_t *lru;
+    uint32_t i;
+
+    if ( (NULL == cache) || (NULL == ctx) || ( (NULL == prefix) && (len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    lru = &cache->entry[0];
+    for(i = 0; i < SHA3_PREFIX_CACHE_SLOTS; i++)
+    {
+        e = &cache->entry[i];
+        if ( (e->stamp != 0) && (e->mode == (uint32_t)mode) && (e->len == len) &&
+             ( (0 == len) || (0 == memcmp(e->prefix, prefix, len)) ) )
+        {
+            cache->hits++;
+            sha3_ctx_clone(ctx, &e->ctx);
+            e->stamp = sha3_prefix_tick(cache);
+            return SHA3_OK;
+        }
+
+        if (e->stamp < lru->stamp)
+        {
+            lru = e;
+        }
+    }
+
+    cache->misses++;
+
+    if ( (SHA3_OK != sha3_init(mode, ctx)) ||
+         (SHA3_OK != sha3_update(ctx, prefix, len)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    if (len <= SHA3_PREFIX_MAX_LEN)
+    {
+        sha3_ctx_clone(&lru->ctx, ctx);
+        lru->mode = (uint32_t)mode;
+        lru->len = len;
+        if (len != 0)
+        {
+            memcpy(lru->prefix, prefix, len);
+        }
+        lru->stamp = sha3_prefix_tick(cache);
+    }
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_squeeze(sha3_ctx_t *ctx, uint8_t *output_data, size_t len)
+{
+    if ( (NULL == ctx) || ( (NULL == output_data) && (len != 0) ) ||
+         !(ctx->flags & SHA3_FLAG_XOF) )
+    {
+        return SHA3_ERROR;
+    }
+
+    SHA3_STATS_BEGIN(SHA3_STATS_SQUEEZE, NULL, len);
+    sha3_sponge_xof(ctx, output_data, len);
+    SHA3_STATS_END(SHA3_STATS_SQUEEZE, NULL, len);
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+void sha3_sponge_forget(sha3_ctx_t *ctx)
+{
+    // zero lanes are zero in every kernel layout
+    memset(ctx->s, 0, ctx->bs);
+    KECCAK_PERMUTE(ctx->s, ctx->rounds);
+    SHA3_STATS_ADD(permutations, 1);
+
+    memset(ctx->buf, 0, sizeof(ctx->buf));
+    ctx->buf_len = 0;
+    ctx->flags &= (uint8_t)~SHA3_FLAG_SQUEEZING;
+}
+
+// Duplex
+//-------------------------------------------------------
+sha3_status_t sha3_duplex_init(sha3_hash_modes_t mode, sha3_ctx_t *ctx)
+{
+    if (SHA3_OK != sha3_init(mode, ctx))
+    {
+        return SHA3_ERROR;
+    }
+
+    // sponge calls fail on a padded context without XOF
+    ctx->flags = SHA3_FLAG_DUPLEX | SHA3_FLAG_SQUEEZING;
+
+    return SHA3_OK;
+}
+
+// XOR len (< bs) bytes and the domain and pad10*1 bits into the rate and
+// permute. With output_data the rate is XORed over the block first, as
+// keystream: encryption absorbs the input block, decryption the output.
+//-------------------------------------------------------
+static void sha3_duplex_block(sha3_ctx_t *ctx,
+                              const uint8_t *input_data,
+                              uint8_t *output_data,
+                              size_t len,
+                              uint8_t domain,
+                              int decrypt)
+{
+    uint8_t lane[8];
+    uint64_t x, z;
+    size_t i, tail;
+
+    for(i = 0; i + 8 <= len; i += 8)
+    {
+        x = load64_le(input_data + i);
+        if (NULL != output_data)
+        {
+            z = x ^ KECCAK_LANE_OUT(ctx->s[i / 8]);
+            store64_le(output_data + i, z);
+            x = decrypt ? z : x;
+        }
+        ctx->s[i / 8] ^= KECCAK_LANE_IN(x);
+    }
+
+    // the last lane takes the remaining bytes and the domain byte
+    tail = len - i;
+    memset(lane, 0, sizeof(lane));
+    if (tail != 0)
+    {
+        memcpy(lane, input_data + i, tail);
+    }
+    x = load64_le(lane);
+
+    if (NULL != output_data)
+    {
+        z = x ^ KECCAK_LANE_OUT(ctx->s[i / 8]);
+        store64_le(lane, z);
+        if (tail != 0)
+        {
+            memcpy(output_data + i, lane, tail);
+        }
+        x = decrypt ? (z & ((tail != 0) ? (~(uint64_t)0 >> (64 - 8 * tail)) : 0)) : x;
+    }
+
+    ctx->s[i / 8] ^= KECCAK_LANE_IN(x | ((uint64_t)domain << (8 * tail)));
+    ctx->s[ctx->bs / 8 - 1] ^= KECCAK_LANE_IN((uint64_t)SHA3_PAD_LAST << 56);
+
+    KECCAK_PERMUTE(ctx->s, ctx->rounds);
+    SHA3_STATS_ADD(permutations, 1);
+    SHA3_STATS_ADD(bytes_absorbed, len);
+}
+
+//-------------------------------------------------------
+static sha3_status_t sha3_duplex_check(const sha3_ctx_t *ctx,
+                                       const uint8_t *input_data,
+                                       const uint8_t *output_data,
+                                       size_t len,
+                                       uint8_t domain)
+{
+    if ( (NULL == ctx) || !(ctx->flags & SHA3_FLAG_DUPLEX) ||
+         (len >= ctx->bs) || (domain < 0x01) || (domain > 0x7F) ||
+         ( (len != 0) && ( (NULL == input_data) || (NULL == output_data) ) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_duplex(sha3_ctx_t *ctx,
+                          const uint8_t *input_data,
+                          size_t len,
+                          uint8_t domain,
+                          uint8_t *output_data,
+                          size_t output_len)
+{
+    if ( (SHA3_OK != sha3_duplex_check(ctx, input_data, input_data, len, domain)) ||
+         (output_len > ctx->bs) || ( (NULL == output_data) && (output_len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    sha3_duplex_block(ctx, input_data, NULL, len, domain, 0);
+
+    return sha3_duplex_output(ctx, output_data, output_len);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_duplex_output(const sha3_ctx_t *ctx, uint8_t *output_data, size_t len)
+{
+    if ( (NULL == ctx) || !(ctx->flags & SHA3_FLAG_DUPLEX) ||
+         (len > ctx->bs) || ( (NULL == output_data) && (len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    sha3_store_state(output_data, ctx->s, (uint32_t)len);
+    SHA3_STATS_ADD(bytes_squeezed, len);
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_duplex_encrypt(sha3_ctx_t *ctx,
+                                  const uint8_t *input_data,
+                                  uint8_t *output_data,
+                                  size_t len,
+                                  uint8_t domain)
+{
+    if (SHA3_OK != sha3_duplex_check(ctx, input_data, output_data, len, domain))
+    {
+        return SHA3_ERROR;
+    }
+
+    sha3_duplex_block(ctx, input_data, output_data, len, domain, 0);
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_duplex_decrypt(sha3_ctx_t *ctx,
+                                  const uint8_t *input_data,
+                                  uint8_t *output_data,
+                                  size_t len,
+                                  uint8_t domain)
+{
+    if (SHA3_OK != sha3_duplex_check(ctx, input_data, output_data, len, domain))
+    {
+        return SHA3_ERROR;
+    }
+
+    sha3_duplex_block(ctx, input_data, output_data, len, domain, 1);
+
+    return SHA3_OK;
+}
+
+// SP 800-185 encodings
+//-------------------------------------------------------
+uint32_t sha3_left_encode(uint64_t x, uint8_t *output_data)
+{
+    uint32_t n = 1;
+    uint32_t i;
+
+    while ( (n < 8) && (x >> (8 * n)) )
+    {
+        n++;
+    }
+
+    output_data[0] = (uint8_t)n;
+    for(i = 0; i < n; i++)
+    {
+        output_data[1 + i] = (uint8_t)(x >> (8 * (n - 1 - i)));
+    }
+
+    return n + 1;
+}
+
+//-------------------------------------------------------
+uint32_t sha3_right_encode(uint64_t x, uint8_t *output_data)
+{
+    uint32_t n = sha3_left_encode(x, output_data) - 1;
+
+    memmove(output_data, output_data + 1, n);
+    output_data[n] = (uint8_t)n;
+
+    return n + 1;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_update_bytepad(sha3_ctx_t *ctx,
+                                  const uint8_t *const str[],
+                                  const size_t len[],
+                                  uint32_t num)
+{
+    static const uint8_t zeros[SHA3_MAX_RATE_LEN] = {0};
+    uint8_t enc[SHA3_ENCODE_MAX_LEN];
+    uint64_t total;
+    uint32_t n, i;
+
+    if ( (NULL == ctx) || ( (num != 0) && ( (NULL == str) || (NULL == len) ) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    // bytepad(encode_string(str[0]) || ... || encode_string(str[num - 1]), rate)
+    n = sha3_left_encode(ctx->bs, enc);
+    total = n;
+    if (SHA3_OK != sha3_update(ctx, enc, n))
+    {
+        return SHA3_ERROR;
+    }
+
+    for(i = 0; i < num; i++)
+    {
+        n = sha3_left_encode((uint64_t)len[i] * 8, enc);
+        total += n + len[i];
+        if ( (SHA3_OK != sha3_update(ctx, enc, n)) ||
+             (SHA3_OK != sha3_update(ctx, str[i], len[i])) )
+        {
+            return SHA3_ERROR;
+        }
+    }
+
+    n = (ctx->bs - total % ctx->bs) % ctx->bs;
+
+    return sha3_update(ctx, zeros, n);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_cshake_init(sha3_hash_modes_t mode,
+                               sha3_ctx_t *ctx,
+                               const uint8_t *name,
+                               size_t name_len,
+                               const uint8_t *custom,
+                               size_t custom_len)
+{
+    const uint8_t *str[2];
+    size_t len[2];
+
+    if ( ( (SHAKE128 != mode) && (SHAKE256 != mode) ) ||
+         ( (NULL == name) && (name_len != 0) ) ||
+         ( (NULL == custom) && (custom_len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    if (SHA3_OK != sha3_init(mode, ctx))
+    {
+        return SHA3_ERROR;
+    }
+
+    // cSHAKE with empty N and S is plain SHAKE
+    if ( (0 == name_len) && (0 == custom_len) )
+    {
+        return SHA3_OK;
+    }
+
+    ctx->pad = CSHAKE_DOMAIN_PAD;
+
+    str[0] = name;
+    len[0] = name_len;
+    str[1] = custom;
+    len[1] = custom_len;
+
+    return sha3_update_bytepad(ctx, str, len, 2);
+}
+
+//-------------------------------------------------------
+sha3_status_t SHA3(sha3_hash_modes_t mode, const uint8_t *input_data, size_t len, uint8_t *output_data)
+{
+	sha3_status_t res = SHA3_OK; 
+	sha3_ctx_t ctx;
+	
+	if ( (input_data == NULL) || (output_data == NULL) )
+	{
+		return SHA3_ERROR;
+	}
+	
+	res = sha3_init(mode ,&ctx);
+	if (SHA3_OK == res)
+	{
+		res = sha3_update(&ctx, input_data, len);
+	}
+	if (SHA3_OK == res)
+	{
+		res = sha3_final(&ctx, output_data);
+	}
+	
+	return res;
+}
+
+// Message of in_lanes whole lanes that fits in one rate block: lanes and
+// pad bits are written to the state directly, one permutation
+//-------------------------------------------------------
+static inline void sha3_hash_block(const uint8_t *input_data,
+                                   uint32_t in_lanes,
+                                   uint32_t bs,
+                                   uint8_t pad,
+                                   uint32_t rounds,
+                                   uint8_t *output_data,
+                                   uint32_t d)
+{
+    uint64_t s[SHA3_STATE_LEN / 8] = {0};
+    uint32_t i;
+
+    for(i = 0; i < in_lanes; i++)
+    {
+        s[i] = KECCAK_LANE_IN(load64_le(input_data + 8 * i));
+    }
+
+    s[in_lanes] = KECCAK_LANE_IN((uint64_t)pad);
+    s[bs / 8 - 1] ^= KECCAK_LANE_IN((uint64_t)SHA3_PAD_LAST << 56);
+
+    KECCAK_PERMUTE(s, rounds);
+    SHA3_STATS_ADD(permutations, 1);
+    SHA3_STATS_ADD(bytes_absorbed, 8 * in_lanes);
+    SHA3_STATS_ADD(bytes_squeezed, d);
+
+    sha3_store_state(output_data, s, d);
+}
+
+// Single block hash with the parameters of every mode as literals, each
+// case folds to constants once inlined with a constant in_lanes
+//-------------------------------------------------------
+static inline sha3_status_t sha3_hash_fixed(sha3_hash_modes_t mode,
+                                            const uint8_t *input_data,
+                                            uint32_t in_lanes,
+                                            uint8_t *output_data)
+{
+    if ( (input_data == NULL) || (output_data == NULL) )
+    {
+        return SHA3_ERROR;
+    }
+
+    SHA3_STATS_BEGIN(SHA3_STATS_BLOCK, input_data, 8 * in_lanes);
+    SHA3_STATS_CALLS(mode, 1);
+
+    switch(mode)
+    {
+        case SHA3_224:
+            sha3_hash_block(input_data, in_lanes, 144, SHA3_DOMAIN_PAD, KECCAK_ROUNDS, output_data, SHA3_224_HASH_LEN);
+            break;
+        case SHA3_256:
+            sha3_hash_block(input_data, in_lanes, 136, SHA3_DOMAIN_PAD, KECCAK_ROUNDS, output_data, SHA3_256_HASH_LEN);
+            break;
+        case SHA3_384:
+            sha3_hash_block(input_data, in_lanes, 104, SHA3_DOMAIN_PAD, KECCAK_ROUNDS, output_data, SHA3_384_HASH_LEN);
+            break;
+        case SHA3_512:
+            sha3_hash_block(input_data, in_lanes, 72, SHA3_DOMAIN_PAD, KECCAK_ROUNDS, output_data, SHA3_512_HASH_LEN);
+            break;
+        case SHAKE128:
+            sha3_hash_block(input_data, in_lanes, 168, SHAKE_DOMAIN_PAD, KECCAK_ROUNDS, output_data, SHAKE128_HASH_LEN);
+            break;
+        case SHAKE256:
+            sha3_hash_block(input_data, in_lanes, 136, SHAKE_DOMAIN_PAD, KECCAK_ROUNDS, output_data, SHAKE256_HASH_LEN);
+            break;
+        case TURBOSHAKE128:
+            sha3_hash_block(input_data, in_lanes, 168, TURBOSHAKE_DOMAIN_PAD, TURBOSHAKE_ROUNDS, output_data, SHAKE128_HASH_LEN);
+            break;
+        case TURBOSHAKE256:
+            sha3_hash_block(input_data, in_lanes, 136, TURBOSHAKE_DOMAIN_PAD, TURBOSHAKE_ROUNDS, output_data, SHAKE256_HASH_LEN);
+            break;
+        default:
+            SHA3_STATS_END(SHA3_STATS_BLOCK, input_data, 8 * in_lanes);
+            return SHA3_ERROR;
+    }
+
+    SHA3_STATS_END(SHA3_STATS_BLOCK, input_data, 8 * in_lanes);
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t SHA3_32(sha3_hash_modes_t mode, const uint8_t *input_data, uint8_t *output_data)
+{
+    return sha3_hash_fixed(mode, input_data, 4, output_data);
+}
+
+//-------------------------------------------------------
+sha3_status_t SHA3_64(sha3_hash_modes_t mode, const uint8_t *input_data, uint8_t *output_data)
+{
+    return sha3_hash_fixed(mode, input_data, 8, output_data);
+}
+
+//-------------------------------------------------------
+sha3_status_t SHAKE(sha3_hash_modes_t mode, const uint8_t *input_data, size_t len, uint8_t *output_data, size_t output_len)
+{
+	sha3_status_t res = SHA3_OK;
+	sha3_ctx_t ctx;
+
+	if ( (input_data == NULL) || (output_data == NULL) )
+	{
+		return SHA3_ERROR;
+	}
+
+	res = sha3_init(mode, &ctx);
+	if (SHA3_OK == res)
+	{
+		res = sha3_update(&ctx, input_data, len);
+	}
+	if (SHA3_OK == res)
+	{
+		res = sha3_squeeze(&ctx, output_data, output_len);
+	}
+
+	return res;
+}
+
+//-------------------------------------------------------
+sha3_status_t TURBOSHAKE(sha3_hash_modes_t mode,
+                         uint8_t domain,
+                         const uint8_t *input_data,
+                         size_t len,
+                         uint8_t *output_data,
+                         size_t output_len)
+{
+	sha3_status_t res = SHA3_OK;
+	sha3_ctx_t ctx;
+
+	if ( (input_data == NULL) || (output_data == NULL) )
+	{
+		return SHA3_ERROR;
+	}
+
+	res = sha3_turboshake_init(mode, &ctx, domain);
+	if (SHA3_OK == res)
+	{
+		res = sha3_update(&ctx, input_data, len);
+	}
+	if (SHA3_OK == res)
+	{
+		res = sha3_squeeze(&ctx, output_data, output_len);
+	}
+
+	return res;
+}
+
+//-------------------------------------------------------
+sha3_status_t CSHAKE(sha3_hash_modes_t mode,
+                     const uint8_t *input_data,
+                     size_t len,
+                     const uint8_t *name,
+                     size_t name_len,
+                     const uint8_t *custom,
+                     size_t custom_len,
+                     uint8_t *output_data,
+                     size_t output_len)
+{
+	sha3_status_t res = SHA3_OK;
+	sha3_ctx_t ctx;
+
+	if ( (input_data == NULL) || (output_data == NULL) )
+	{
+		return SHA3_ERROR;
+	}
+
+	res = sha3_cshake_init(mode, &ctx, name, name_len, custom, custom_len);
+	if (SHA3_OK == res)
+	{
+		res = sha3_update(&ctx, input_data, len);
+	}
+	if (SHA3_OK == res)
+	{
+		res = sha3_squeeze(&ctx, output_data, output_len);
+	}
+
+	return res;
+}
+
+// Multi-message hashing
+//-------------------------------------------------------
+
+// Hash up to impl->lanes messages in the interleaved states of a
+// multi-lane kernel. A lane whose message is absent or already finished
+// is masked: it gets no input and whatever the permutation leaves in it
+// is ignored. Message k is head[k] (head_len bytes, at most one block)
+// followed by input_data[k].
+//-------------------------------------------------------
+static void sha3_hash_lanes(const keccak_impl_t *impl,
+                            uint32_t bs,
+                            uint32_t d,
+                            uint8_t pad,
+                            uint32_t rounds,
+                            const uint8_t *const *head,
+                            uint32_t head_len,
+                            const uint8_t *const *input_data,
+                            const size_t *len,
+                            uint8_t *const *output_data,
+                            uint32_t num)
+{
+    uint64_t s[25 * KECCAK_MAX_LANES];
+    uint8_t last[SHA3_MAX_RATE_LEN];
+    size_t off[KECCAK_MAX_LANES] = {0};        // position in head || input
+    uint8_t active[KECCAK_MAX_LANES] = {0};
+    uint8_t final[KECCAK_MAX_LANES] = {0};
+    const uint8_t *block;
+    uint32_t stride = impl->lanes;
+    uint32_t lanes = bs / 8;
+    uint32_t pending = num;
+    uint32_t fill;
+    uint32_t i, k;
+    size_t pos, n;
+
+    memset(s, 0, 25 * stride * sizeof(uint64_t));
+
+    for(k = 0; k < num; k++)
+    {
+        active[k] = 1;
+        SHA3_STATS_ADD(bytes_absorbed, head_len + len[k]);
+    }
+    SHA3_STATS_ADD(bytes_squeezed, (uint64_t)d * num);
+
+    while (pending != 0)
+    {
+        for(k = 0; k < num; k++)
+        {
+            if (!active[k])
+            {
+                continue;
+            }
+
+            pos = off[k];
+            if ( (pos >= head_len) && (head_len + len[k] - pos >= bs) )
+            {
+                block = input_data[k] + (pos - head_len);
+                off[k] += bs;
+            }
+            else
+            {
+                // block with the head or the tail of the message
+                fill = 0;
+                if (pos < head_len)
+                {
+                    fill = head_len - (uint32_t)pos;
+                    memcpy(last, head[k] + pos, fill);
+                    pos = head_len;
+                }
+
+                n = len[k] - (pos - head_len);
+                if (n > bs - fill)
+                {
+                    n = bs - fill;
+                }
+                if (n != 0)
+                {
+                    memcpy(last + fill, input_data[k] + (pos - head_len), n);
+                }
+                fill += (uint32_t)n;
+                off[k] = pos + n;
+
+                if (fill < bs)
+                {
+                    sha3_pad_block(last, fill, bs, pad);
+                    final[k] = 1;
+                }
+                block = last;
+            }
+
+            for(i = 0; i < lanes; i++)
+            {
+                s[stride * i + k] ^= load64_le(block + 8 * i);
+            }
+        }
+
+        impl->permute(s, rounds);
+        SHA3_STATS_ADD(lane_permutations, 1);
+        SHA3_STATS_ADD(lanes_busy, pending);
+
+        for(k = 0; k < num; k++)
+        {
+            if (active[k] && final[k])
+            {
+                sha3_store_lanes(output_data[k], s + k, stride, d);
+                active[k] = 0;
+                pending--;
+            }
+        }
+    }
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_lane_init(sha3_lane_t *lane,
+                             sha3_hash_modes_t mode,
+                             const uint8_t *input_data,
+                             size_t len,
+                             uint8_t *output_data)
+{
+    uint16_t r, c, d;
+    uint8_t pad, rounds;
+
+    if ( (NULL == lane) || (NULL == output_data) || ( (NULL == input_data) && (len != 0) ) ||
+         (SHA3_OK != sha3_mode_params(mode, &r, &c, &d, &pad, &rounds)) ||
+         (KECCAK_ROUNDS != rounds) )
+    {
+        return SHA3_ERROR;
+    }
+
+    lane->input_data = input_data;
+    lane->len = len;
+    lane->off = 0;
+    lane->output_data = output_data;
+    lane->bs = r / 8;
+    lane->d = d;
+    lane->pad = pad;
+    lane->final = 0;
+    lane->done = 0;
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+uint32_t sha3_lanes_step(const keccak_impl_t *impl, uint64_t *s, sha3_lane_t *const *lane)
+{
+    uint8_t last[SHA3_MAX_RATE_LEN];
+    const uint8_t *block;
+    uint32_t stride = impl->lanes;
+    uint32_t finished = 0;
+    uint32_t i, k;
+    size_t rem;
+
+    for(k = 0; k < stride; k++)
+    {
+        if ( (NULL == lane[k]) || lane[k]->done )
+        {
+            continue;
+        }
+
+        rem = lane[k]->len - lane[k]->off;
+        if (rem >= lane[k]->bs)
+        {
+            block = lane[k]->input_data + lane[k]->off;
+            lane[k]->off += lane[k]->bs;
+        }
+        else
+        {
+            if (rem != 0)
+            {
+                memcpy(last, lane[k]->input_data + lane[k]->off, rem);
+            }
+            sha3_pad_block(last, (uint32_t)rem, lane[k]->bs, lane[k]->pad);
+            block = last;
+            lane[k]->off = lane[k]->len;
+            lane[k]->final = 1;
+        }
+
+        for(i = 0; i < lane[k]->bs / 8u; i++)
+        {
+            s[stride * i + k] ^= load64_le(block + 8 * i);
+        }
+        SHA3_STATS_ADD(lanes_busy, 1);
+    }
+
+    impl->permute(s, KECCAK_ROUNDS);
+    SHA3_STATS_ADD(lane_permutations, 1);
+
+    for(k = 0; k < stride; k++)
+    {
+        if ( (NULL != lane[k]) && lane[k]->final && !lane[k]->done )
+        {
+            sha3_store_lanes(lane[k]->output_data, s + k, stride, lane[k]->d);
+            SHA3_STATS_ADD(bytes_absorbed, lane[k]->len);
+            SHA3_STATS_ADD(bytes_squeezed, lane[k]->d);
+            lane[k]->done = 1;
+            finished++;
+        }
+    }
+
+    return finished;
+}
+
+// Batch of messages through the multi-lane kernel, up to d bytes
+// of output each (d has to fit in one rate block)
+//-------------------------------------------------------
+static sha3_status_t sha3_hash_batch(uint32_t bs,
+                                     size_t d,
+                                     uint8_t pad,
+                                     uint32_t rounds,
+                                     const uint8_t *const *head,
+                                     uint32_t head_len,
+                                     const uint8_t *const *input_data,
+                                     const size_t *len,
+                                     uint8_t *const *output_data,
+                                     uint32_t num)
+{
+    const keccak_impl_t *impl;
+    uint32_t i, n;
+
+    if ( (NULL == input_data) || (NULL == len) || (NULL == output_data) || (d > bs) ||
+         (head_len > bs) || ( (NULL == head) && (head_len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    for(i = 0; i < num; i++)
+    {
+        if ( (NULL == output_data[i]) || ( (NULL == input_data[i]) && (len[i] != 0) ) ||
+             ( (head_len != 0) && (NULL == head[i]) ) )
+        {
+            return SHA3_ERROR;
+        }
+    }
+
+    impl = keccak_get_impl();
+    SHA3_STATS_BEGIN(SHA3_STATS_BATCH, input_data, num);
+
+    for(i = 0; i < num; i += n)
+    {
+        n = num - i;
+        if (n > impl->lanes)
+        {
+            n = impl->lanes;
+        }
+
+        sha3_hash_lanes(impl, bs, (uint32_t)d, pad, rounds, (head_len != 0) ? head + i : NULL, head_len,
+                        input_data + i, len + i, output_data + i, n);
+    }
+
+    SHA3_STATS_END(SHA3_STATS_BATCH, input_data, num);
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_hash_many(sha3_hash_modes_t mode,
+                             const uint8_t *const *input_data,
+                             const size_t *len,
+                             uint8_t *const *output_data,
+                             uint32_t num)
+{
+    uint16_t r, c, d;
+    uint8_t pad, rounds;
+
+    if (SHA3_OK != sha3_mode_params(mode, &r, &c, &d, &pad, &rounds))
+    {
+        return SHA3_ERROR;
+    }
+
+    SHA3_STATS_CALLS(mode, num);
+    return sha3_hash_batch(r / 8, d, pad, rounds, NULL, 0, input_data, len, output_data, num);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_hash_many_head(sha3_hash_modes_t mode,
+                                  const uint8_t *const *head,
+                                  size_t head_len,
+                                  const uint8_t *const *input_data,
+                                  const size_t *len,
+                                  uint8_t *const *output_data,
+                                  uint32_t num)
+{
+    uint16_t r, c, d;
+    uint8_t pad, rounds;
+
+    if ( (NULL == head) || (head_len > SHA3_MAX_RATE_LEN) ||
+         (SHA3_OK != sha3_mode_params(mode, &r, &c, &d, &pad, &rounds)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    SHA3_STATS_CALLS(mode, num);
+    return sha3_hash_batch(r / 8, d, pad, rounds, head, (uint32_t)head_len, input_data, len, output_data, num);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_turboshake_many(sha3_hash_modes_t mode,
+                                   uint8_t domain,
+                                   const uint8_t *const *input_data,
+                                   const size_t *len,
+                                   uint8_t *const *output_data,
+                                   size_t output_len,
+                                   uint32_t num)
+{
+    uint16_t r, c, d;
+    uint8_t pad, rounds;
+
+    if ( ( (TURBOSHAKE128 != mode) && (TURBOSHAKE256 != mode) ) ||
+         (domain < 0x01) || (domain > 0x7F) ||
+         (SHA3_OK != sha3_mode_params(mode, &r, &c, &d, &pad, &rounds)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    SHA3_STATS_CALLS(mode, num);
+    return sha3_hash_batch(r / 8, output_len, domain, rounds, NULL, 0, input_data, len, output_data, num);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_hash_x4(sha3_hash_modes_t mode,
+                           const uint8_t *const input_data[4],
+                           const size_t len[4],
+                           uint8_t *const output_data[4])
+{
+    return sha3_hash_many(mode, input_data, len, output_data, 4);
 }
@@ -0,0 +1,228 @@
+/**
+* @file  sha3_aead.c
+* @brief Keccak duplex authenticated encryption
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  03.01.2014
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string.h>
+
+#include "sha3_aead.h"
+
+// Duplex domain bytes: field (1 key and nonce, 2 associated data,
+// 3 plaintext), 0x04 on the last block of a field, 0x08 first pad bit
+#define SHA3_AEAD_D_INIT     0x0D
+#define SHA3_AEAD_D_AD       0x0A
+#define SHA3_AEAD_D_AD_LAST  0x0E
+#define SHA3_AEAD_D_MSG      0x0B
+#define SHA3_AEAD_D_MSG_LAST 0x0F
+
+
+//-----------------------------------------------------------------------------
+static uint32_t sha3_aead_equal(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    uint32_t diff = 0;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        diff |= a[i] ^ b[i];
+    }
+
+    return (diff - 1) >> 31;
+}
+
+
+// Keys the duplex with key and nonce and absorbs the associated data
+//-----------------------------------------------------------------------------
+static sha3_aead_status_t sha3_aead_start(sha3_aead_mode_t mode,
+                                          sha3_ctx_t *ctx,
+                                          const uint8_t *key,
+                                          size_t key_len,
+                                          const uint8_t *nonce,
+                                          size_t nonce_len,
+                                          const uint8_t *ad,
+                                          size_t ad_len,
+                                          size_t tag_len)
+{
+    uint8_t block[1 + SHA3_AEAD_MAX_KEY_LEN + SHA3_AEAD_MAX_NONCE_LEN];
+    sha3_hash_modes_t sha_mode;
+    size_t rho;
+
+    if ( (NULL == key) || (key_len < SHA3_AEAD_MIN_KEY_LEN) || (key_len > SHA3_AEAD_MAX_KEY_LEN) ||
+         ( (NULL == nonce) && (nonce_len != 0) ) || (nonce_len > SHA3_AEAD_MAX_NONCE_LEN) ||
+         ( (NULL == ad) && (ad_len != 0) ) ||
+         (tag_len < SHA3_AEAD_MIN_TAG_LEN) || (tag_len > SHA3_AEAD_MAX_TAG_LEN) )
+    {
+        return SHA3_AEAD_ERROR;
+    }
+
+    switch(mode)
+    {
+        case SHA3_AEAD_128:
+            sha_mode = SHAKE128;
+            break;
+        case SHA3_AEAD_256:
+            sha_mode = SHAKE256;
+            break;
+        case SHA3_AEAD_TURBO128:
+            sha_mode = TURBOSHAKE128;
+            break;
+        case SHA3_AEAD_TURBO256:
+            sha_mode = TURBOSHAKE256;
+            break;
+        default:
+            return SHA3_AEAD_ERROR;
+    }
+
+    if (SHA3_OK != sha3_duplex_init(sha_mode, ctx))
+    {
+        return SHA3_AEAD_ERROR;
+    }
+
+    // key_len || key || nonce
+    block[0] = (uint8_t)key_len;
+    memcpy(block + 1, key, key_len);
+    if (nonce_len != 0)
+    {
+        memcpy(block + 1 + key_len, nonce, nonce_len);
+    }
+
+    sha3_duplex(ctx, block, 1 + key_len + nonce_len, SHA3_AEAD_D_INIT, NULL, 0);
+    memset(block, 0, sizeof(block));
+
+    // no associated data, no block
+    rho = ctx->bs - 1;
+    while (ad_len > rho)
+    {
+        sha3_duplex(ctx, ad, rho, SHA3_AEAD_D_AD, NULL, 0);
+        ad += rho;
+        ad_len -= rho;
+    }
+
+    if (ad_len != 0)
+    {
+        sha3_duplex(ctx, ad, ad_len, SHA3_AEAD_D_AD_LAST, NULL, 0);
+    }
+
+    return SHA3_AEAD_OK;
+}
+
+
+//-----------------------------------------------------------------------------
+sha3_aead_status_t SHA3_AEAD_ENCRYPT(sha3_aead_mode_t mode,
+                                     const uint8_t *key,
+                                     size_t key_len,
+                                     const uint8_t *nonce,
+                                     size_t nonce_len,
+                                     const uint8_t *ad,
+                                     size_t ad_len,
+                                     const uint8_t *input_data,
+                                     size_t len,
+                                     uint8_t *output_data,
+                                     uint8_t *tag,
+                                     size_t tag_len)
+{
+    sha3_ctx_t ctx;
+    size_t rho;
+
+    if ( ( (len != 0) && ( (NULL == input_data) || (NULL == output_data) ) ) || (NULL == tag) ||
+         (SHA3_AEAD_OK != sha3_aead_start(mode, &ctx, key, key_len, nonce, nonce_len, ad, ad_len, tag_len)) )
+    {
+        return SHA3_AEAD_ERROR;
+    }
+
+    // the last plaintext block is absorbed even when empty
+    rho = ctx.bs - 1;
+    while (len > rho)
+    {
+        sha3_duplex_encrypt(&ctx, input_data, output_data, rho, SHA3_AEAD_D_MSG);
+        input_data += rho;
+        output_data += rho;
+        len -= rho;
+    }
+
+    sha3_duplex_encrypt(&ctx, input_data, output_data, len, SHA3_AEAD_D_MSG_LAST);
+    sha3_duplex_output(&ctx, tag, tag_len);
+    memset(&ctx, 0, sizeof(ctx));
+
+    return SHA3_AEAD_OK;
+}
+
+
+//-----------------------------------------------------------------------------
+sha3_aead_status_t SHA3_AEAD_DECRYPT(sha3_aead_mode_t mode,
+                                     const uint8_t *key,
+                                     size_t key_len,
+                                     const uint8_t *nonce,
+                                     size_t nonce_len,
+                                     const uint8_t *ad,
+                                     size_t ad_len,
+                                     const uint8_t *input_data,
+                                     size_t len,
+                                     const uint8_t *tag,
+                                     size_t tag_len,
+                                     uint8_t *output_data)
+{
+    uint8_t mac[SHA3_AEAD_MAX_TAG_LEN];
+    uint8_t *plain = output_data;
+    size_t plain_len = len;
+    sha3_ctx_t ctx;
+    uint32_t equal;
+    size_t rho;
+
+    if ( ( (len != 0) && ( (NULL == input_data) || (NULL == output_data) ) ) || (NULL == tag) ||
+         (SHA3_AEAD_OK != sha3_aead_start(mode, &ctx, key, key_len, nonce, nonce_len, ad, ad_len, tag_len)) )
+    {
+        return SHA3_AEAD_ERROR;
+    }
+
+    rho = ctx.bs - 1;
+    while (len > rho)
+    {
+        sha3_duplex_decrypt(&ctx, input_data, output_data, rho, SHA3_AEAD_D_MSG);
+        input_data += rho;
+        output_data += rho;
+        len -= rho;
+    }
+
+    sha3_duplex_decrypt(&ctx, input_data, output_data, len, SHA3_AEAD_D_MSG_LAST);
+    sha3_duplex_output(&ctx, mac, tag_len);
+    memset(&ctx, 0, sizeof(ctx));
+
+    equal = sha3_aead_equal(mac, tag, tag_len);
+    memset(mac, 0, sizeof(mac));
+
+    if (!equal)
+    {
+        if (plain_len != 0)
+        {
+            memset(plain, 0, plain_len);
+        }
+        return SHA3_AEAD_TAG_MISMATCH;
+    }
+
+    return SHA3_AEAD_OK;
+}
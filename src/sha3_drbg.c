@@ -0,0 +1,284 @@
+/**
+* @file  sha3_drbg.c
+* @brief Keccak sponge deterministic random bit generator
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+
+#include "sha3_drbg.h"
+#include "sha3_internal.h"
+
+#define SHA3_DRBG_OS_SEED_LEN 48
+
+// Tells reseed entropy and additional input apart
+#define SHA3_DRBG_TAG_RESEED     0x01
+#define SHA3_DRBG_TAG_ADDITIONAL 0x02
+
+static const uint8_t sha3_drbg_label[] = { 'S', 'H', 'A', '3', '-', 'D', 'R', 'B', 'G' };
+
+static __thread sha3_drbg_t sha3_drbg_tls;
+static pthread_once_t sha3_drbg_once = PTHREAD_ONCE_INIT;
+static uint32_t sha3_drbg_fork_gen = 1;
+
+
+// encode_string(str): left_encode(bit length) || str
+//-------------------------------------------------------
+static void sha3_drbg_absorb_string(sha3_ctx_t *ctx, const uint8_t *str, size_t len)
+{
+    uint8_t enc[SHA3_ENCODE_MAX_LEN];
+
+    sha3_update(ctx, enc, sha3_left_encode((uint64_t)len * 8, enc));
+    if (len != 0)
+    {
+        sha3_update(ctx, str, len);
+    }
+}
+
+// tag || encode_string(str)
+//-------------------------------------------------------
+static void sha3_drbg_absorb_tagged(sha3_ctx_t *ctx, uint8_t tag, const uint8_t *str, size_t len)
+{
+    sha3_update(ctx, &tag, 1);
+    sha3_drbg_absorb_string(ctx, str, len);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_drbg_seed(sha3_drbg_t *drbg,
+                             sha3_hash_modes_t mode,
+                             const uint8_t *entropy,
+                             size_t entropy_len,
+                             const uint8_t *pers,
+                             size_t pers_len)
+{
+    const uint8_t *label = sha3_drbg_label;
+    size_t label_len = sizeof(sha3_drbg_label);
+    sha3_status_t status;
+
+    if ( (NULL == drbg) || (NULL == entropy) || (entropy_len < SHA3_DRBG_SEED_MIN_LEN) ||
+         ( (NULL == pers) && (pers_len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    switch(mode)
+    {
+        case SHAKE128:
+        case SHAKE256:
+            status = sha3_init(mode, &drbg->ctx);
+            break;
+        case TURBOSHAKE128:
+        case TURBOSHAKE256:
+            status = sha3_turboshake_init(mode, &drbg->ctx, 0x1F);
+            break;
+        default:
+            return SHA3_ERROR;
+    }
+
+    // bytepad(encode_string("SHA3-DRBG")) || encode_string(entropy) || encode_string(pers)
+    if ( (SHA3_OK != status) ||
+         (SHA3_OK != sha3_update_bytepad(&drbg->ctx, &label, &label_len, 1)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    sha3_drbg_absorb_string(&drbg->ctx, entropy, entropy_len);
+    sha3_drbg_absorb_string(&drbg->ctx, pers, pers_len);
+
+    drbg->generated = 0;
+    drbg->seeded = 1;
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_drbg_reseed(sha3_drbg_t *drbg, const uint8_t *entropy, size_t entropy_len)
+{
+    if ( (NULL == drbg) || !drbg->seeded || ( (NULL == entropy) && (entropy_len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    sha3_drbg_absorb_tagged(&drbg->ctx, SHA3_DRBG_TAG_RESEED, entropy, entropy_len);
+    drbg->generated = 0;
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_drbg_generate(sha3_drbg_t *drbg,
+                                 uint8_t *output_data,
+                                 size_t len,
+                                 const uint8_t *additional,
+                                 size_t additional_len)
+{
+    if ( (NULL == drbg) || !drbg->seeded || ( (NULL == output_data) && (len != 0) ) ||
+         ( (NULL == additional) && (additional_len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    if (additional_len != 0)
+    {
+        sha3_drbg_absorb_tagged(&drbg->ctx, SHA3_DRBG_TAG_ADDITIONAL, additional, additional_len);
+    }
+
+    // pads whatever was absorbed since the last request, whole blocks
+    // are stored directly into output_data
+    sha3_squeeze(&drbg->ctx, output_data, len);
+    sha3_sponge_forget(&drbg->ctx);
+    drbg->generated += len;
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+void sha3_drbg_wipe(sha3_drbg_t *drbg)
+{
+    volatile uint8_t *p = (volatile uint8_t *)drbg;
+    size_t i;
+
+    if (NULL == drbg)
+    {
+        return;
+    }
+
+    for(i = 0; i < sizeof(*drbg); i++)
+    {
+        p[i] = 0;
+    }
+}
+
+// Seed material from the kernel
+//-------------------------------------------------------
+static sha3_status_t sha3_drbg_os_entropy(uint8_t *output_data, size_t len)
+{
+    ssize_t n;
+
+#if defined(__linux__)
+    while (len != 0)
+    {
+        n = getrandom(output_data, len, 0);
+        if (n < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            return SHA3_ERROR;
+        }
+        output_data += n;
+        len -= (size_t)n;
+    }
+#else
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        return SHA3_ERROR;
+    }
+
+    while (len != 0)
+    {
+        n = read(fd, output_data, len);
+        if (n <= 0)
+        {
+            if ( (n < 0) && (EINTR == errno) )
+            {
+                continue;
+            }
+            close(fd);
+            return SHA3_ERROR;
+        }
+        output_data += n;
+        len -= (size_t)n;
+    }
+
+    close(fd);
+#endif
+
+    return SHA3_OK;
+}
+
+// The child must not repeat the parent's output
+//-------------------------------------------------------
+static void sha3_drbg_atfork_child(void)
+{
+    __atomic_add_fetch(&sha3_drbg_fork_gen, 1, __ATOMIC_RELAXED);
+}
+
+static void sha3_drbg_register(void)
+{
+    pthread_atfork(NULL, NULL, sha3_drbg_atfork_child);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_random(uint8_t *output_data, size_t len)
+{
+    sha3_drbg_t *drbg = &sha3_drbg_tls;
+    uint8_t seed[SHA3_DRBG_OS_SEED_LEN];
+    uint32_t fork_gen;
+    sha3_status_t status;
+
+    if ( (NULL == output_data) && (len != 0) )
+    {
+        return SHA3_ERROR;
+    }
+
+    fork_gen = __atomic_load_n(&sha3_drbg_fork_gen, __ATOMIC_RELAXED);
+
+    if ( !drbg->seeded || (drbg->fork_gen != fork_gen) ||
+         (drbg->generated >= SHA3_DRBG_RESEED_INTERVAL) )
+    {
+        pthread_once(&sha3_drbg_once, sha3_drbg_register);
+
+        if (SHA3_OK != sha3_drbg_os_entropy(seed, sizeof(seed)))
+        {
+            return SHA3_ERROR;
+        }
+
+        status = drbg->seeded ? sha3_drbg_reseed(drbg, seed, sizeof(seed)) :
+                                sha3_drbg_seed(drbg, TURBOSHAKE128, seed, sizeof(seed), NULL, 0);
+        memset(seed, 0, sizeof(seed));
+
+        if (SHA3_OK != status)
+        {
+            return SHA3_ERROR;
+        }
+
+        drbg->fork_gen = fork_gen;
+    }
+
+    return sha3_drbg_generate(drbg, output_data, len, NULL, 0);
+}
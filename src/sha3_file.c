@@ -0,0 +1,473 @@
+/**
+* @file  sha3_file.c
+* @brief SHA3 hashing of files and file descriptors
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+// 64-bit off_t on 32-bit targets too
+#define _FILE_OFFSET_BITS 64
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sha3.h"
+
+// Mapping window, so 32-bit address spaces can hash large files too
+#define SHA3_FILE_MAP_LEN   ((size_t)1 << 28)
+// read() buffer for pipes, sockets and character devices
+#define SHA3_FILE_BUF_LEN   ((size_t)1 << 20)
+// Pipelined reader: ring slots are page aligned, a side polls its
+// index this many times before it sleeps
+#define SHA3_PIPE_ALIGN     4096
+#define SHA3_PIPE_SPIN      1000
+
+/**
+ * Single-producer/single-consumer ring between the reader thread and
+ * the hashing thread. head and tail count published and released slots,
+ * each is written by one side only. The mutex is only taken to sleep on
+ * an empty or full ring and to wake a sleeping side.
+ */
+typedef struct sha3_pipe
+{
+    uint8_t        *mem;                       // slots * slot_len bytes
+    size_t         *fill;                      // bytes in each slot
+    uint32_t        slots;
+    size_t          slot_len;
+    int             fd;
+    uint32_t        head;                      // producer, atomic
+    uint32_t        tail;                      // consumer, atomic
+    uint32_t        eof;                       // 1 end of input, 2 read error
+    uint32_t        stop;                      // consumer gave up
+    uint32_t        sleeping;                  // sides waiting on cv
+    pthread_mutex_t lock;
+    pthread_cond_t  cv;
+} sha3_pipe_t;
+
+//-------------------------------------------------------
+static sha3_status_t sha3_update_read(sha3_ctx_t *ctx, int fd)
+{
+    uint8_t *buf;
+    ssize_t n;
+    sha3_status_t res = SHA3_OK;
+
+    buf = (uint8_t *)malloc(SHA3_FILE_BUF_LEN);
+    if (NULL == buf)
+    {
+        return SHA3_ERROR;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    while (SHA3_OK == res)
+    {
+        n = read(fd, buf, SHA3_FILE_BUF_LEN);
+        if (n < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            res = SHA3_ERROR;
+        }
+        else if (0 == n)
+        {
+            break;
+        }
+        else
+        {
+            res = sha3_update(ctx, buf, (size_t)n);
+        }
+    }
+
+    free(buf);
+
+    return res;
+}
+
+// Sleeps until pred() holds for the ring
+//-------------------------------------------------------
+static void sha3_pipe_wait(sha3_pipe_t *pipe, int (*pred)(sha3_pipe_t *))
+{
+    uint32_t i;
+
+    for(i = 0; i < SHA3_PIPE_SPIN; i++)
+    {
+        if (pred(pipe))
+        {
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&pipe->lock);
+    __atomic_add_fetch(&pipe->sleeping, 1, __ATOMIC_SEQ_CST);
+    while (!pred(pipe))
+    {
+        pthread_cond_wait(&pipe->cv, &pipe->lock);
+    }
+    __atomic_sub_fetch(&pipe->sleeping, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&pipe->lock);
+}
+
+// Wakes the other side after an index or flag was stored
+//-------------------------------------------------------
+static void sha3_pipe_wake(sha3_pipe_t *pipe)
+{
+    if (0 != __atomic_load_n(&pipe->sleeping, __ATOMIC_SEQ_CST))
+    {
+        pthread_mutex_lock(&pipe->lock);
+        pthread_cond_broadcast(&pipe->cv);
+        pthread_mutex_unlock(&pipe->lock);
+    }
+}
+
+static int sha3_pipe_can_fill(sha3_pipe_t *pipe)
+{
+    return (__atomic_load_n(&pipe->head, __ATOMIC_RELAXED) -
+            __atomic_load_n(&pipe->tail, __ATOMIC_SEQ_CST) < pipe->slots) ||
+           __atomic_load_n(&pipe->stop, __ATOMIC_SEQ_CST);
+}
+
+static int sha3_pipe_can_drain(sha3_pipe_t *pipe)
+{
+    return (__atomic_load_n(&pipe->head, __ATOMIC_SEQ_CST) !=
+            __atomic_load_n(&pipe->tail, __ATOMIC_RELAXED)) ||
+           __atomic_load_n(&pipe->eof, __ATOMIC_SEQ_CST);
+}
+
+// Reader thread: fills a slot and publishes it once it is full, at end
+// of input or when the hashing side has caught up and waits.
+//-------------------------------------------------------
+static void *sha3_pipe_reader(void *arg)
+{
+    sha3_pipe_t *pipe = (sha3_pipe_t *)arg;
+    uint32_t head = 0, eof = 0;
+    size_t fill = 0;
+    uint8_t *slot;
+    ssize_t n;
+
+    // cancelled only while blocked in read(), by a consumer that gave up
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+    while (0 == eof)
+    {
+        if (0 == fill)
+        {
+            // backpressure: wait for the consumer to release a slot
+            sha3_pipe_wait(pipe, sha3_pipe_can_fill);
+            if (__atomic_load_n(&pipe->stop, __ATOMIC_SEQ_CST))
+            {
+                break;
+            }
+        }
+
+        slot = pipe->mem + (size_t)(head % pipe->slots) * pipe->slot_len;
+
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        n = read(pipe->fd, slot + fill, pipe->slot_len - fill);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+        if (n < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            eof = 2;
+        }
+        else if (0 == n)
+        {
+            eof = 1;
+        }
+        else
+        {
+            fill += (size_t)n;
+        }
+
+        if ( (fill != 0) &&
+             ( (fill == pipe->slot_len) || (0 != eof) ||
+               (head == __atomic_load_n(&pipe->tail, __ATOMIC_SEQ_CST)) ) )
+        {
+            pipe->fill[head % pipe->slots] = fill;
+            __atomic_store_n(&pipe->head, ++head, __ATOMIC_SEQ_CST);
+            sha3_pipe_wake(pipe);
+            fill = 0;
+        }
+    }
+
+    __atomic_store_n(&pipe->eof, (0 == eof) ? 1 : eof, __ATOMIC_SEQ_CST);
+    sha3_pipe_wake(pipe);
+
+    return NULL;
+}
+
+//-------------------------------------------------------
+static sha3_status_t sha3_write_all(int fd, const uint8_t *data, size_t len)
+{
+    ssize_t n;
+
+    while (len != 0)
+    {
+        n = write(fd, data, len);
+        if (n < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            return SHA3_ERROR;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_update_fd_pipelined(sha3_ctx_t *ctx, int fd, int tee_fd, uint32_t slots, size_t slot_len)
+{
+    sha3_pipe_t pipe;
+    pthread_t reader;
+    uint32_t tail = 0;
+    const uint8_t *slot;
+    sha3_status_t res;
+    int started;
+    void *mem;
+
+    if ( (NULL == ctx) || (fd < 0) )
+    {
+        return SHA3_ERROR;
+    }
+
+    memset(&pipe, 0, sizeof(pipe));
+    pipe.fd = fd;
+    pipe.slots = (0 == slots) ? SHA3_PIPE_SLOTS : slots;
+    pipe.slot_len = (0 == slot_len) ? SHA3_PIPE_SLOT_LEN : slot_len;
+    pipe.slot_len = (pipe.slot_len + SHA3_PIPE_ALIGN - 1) / SHA3_PIPE_ALIGN * SHA3_PIPE_ALIGN;
+
+    if ( (pipe.slots < 2) || (pipe.slot_len > SIZE_MAX / pipe.slots) ||
+         (0 != posix_memalign(&mem, SHA3_PIPE_ALIGN, pipe.slots * pipe.slot_len)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    pipe.mem = (uint8_t *)mem;
+    pipe.fill = (size_t *)malloc(pipe.slots * sizeof(size_t));
+    if ( (NULL == pipe.fill) ||
+         (0 != pthread_mutex_init(&pipe.lock, NULL)) )
+    {
+        free(pipe.fill);
+        free(mem);
+        return SHA3_ERROR;
+    }
+    pthread_cond_init(&pipe.cv, NULL);
+
+    started = (0 == pthread_create(&reader, NULL, sha3_pipe_reader, &pipe));
+    res = started ? SHA3_OK : SHA3_ERROR;
+
+    // Hash slot by slot as they are published, full blocks go from the
+    // slot straight into the state
+    while (SHA3_OK == res)
+    {
+        sha3_pipe_wait(&pipe, sha3_pipe_can_drain);
+        if (__atomic_load_n(&pipe.head, __ATOMIC_SEQ_CST) == tail)
+        {
+            // drained and the reader is done
+            res = (1 == __atomic_load_n(&pipe.eof, __ATOMIC_SEQ_CST)) ? SHA3_OK : SHA3_ERROR;
+            break;
+        }
+
+        slot = pipe.mem + (size_t)(tail % pipe.slots) * pipe.slot_len;
+        res = sha3_update(ctx, slot, pipe.fill[tail % pipe.slots]);
+        if ( (SHA3_OK == res) && (tee_fd >= 0) )
+        {
+            res = sha3_write_all(tee_fd, slot, pipe.fill[tail % pipe.slots]);
+        }
+
+        __atomic_store_n(&pipe.tail, ++tail, __ATOMIC_SEQ_CST);
+        sha3_pipe_wake(&pipe);
+    }
+
+    if (started)
+    {
+        if (SHA3_OK != res)
+        {
+            // the reader may sit in a read() that never returns
+            __atomic_store_n(&pipe.stop, 1, __ATOMIC_SEQ_CST);
+            sha3_pipe_wake(&pipe);
+            pthread_cancel(reader);
+        }
+        pthread_join(reader, NULL);
+    }
+
+    pthread_cond_destroy(&pipe.cv);
+    pthread_mutex_destroy(&pipe.lock);
+    free(pipe.fill);
+    free(mem);
+
+    return res;
+}
+
+// Absorb [offset, size) of a regular file window by window, the rest is
+// read() once a window can not be mapped.
+//-------------------------------------------------------
+static sha3_status_t sha3_update_mmap(sha3_ctx_t *ctx, int fd, off_t offset, off_t size)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    off_t base;
+    size_t skip, len;
+    uint8_t *map;
+    sha3_status_t res = SHA3_OK;
+
+    if (page <= 0)
+    {
+        return sha3_update_read(ctx, fd);
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, offset, size - offset, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    while ( (SHA3_OK == res) && (offset < size) )
+    {
+        // mmap offsets have to be page aligned
+        base = offset - offset % page;
+        skip = (size_t)(offset - base);
+        len = (size - base > (off_t)SHA3_FILE_MAP_LEN) ? SHA3_FILE_MAP_LEN : (size_t)(size - base);
+
+        map = (uint8_t *)mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, base);
+        if (MAP_FAILED == map)
+        {
+            if (lseek(fd, offset, SEEK_SET) != offset)
+            {
+                return SHA3_ERROR;
+            }
+            return sha3_update_read(ctx, fd);
+        }
+
+        posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+        posix_madvise(map, len, POSIX_MADV_WILLNEED);
+
+        res = sha3_update(ctx, map + skip, len - skip);
+
+        munmap(map, len);
+        offset = base + (off_t)len;
+    }
+
+    return res;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_update_fd(sha3_ctx_t *ctx, int fd)
+{
+    struct stat st;
+    off_t offset;
+
+    if ( (NULL == ctx) || (fd < 0) || (0 != fstat(fd, &st)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    // Files reporting no size (procfs, sysfs) are read() as well
+    offset = S_ISREG(st.st_mode) ? lseek(fd, 0, SEEK_CUR) : -1;
+    if ( (offset < 0) || (offset >= st.st_size) )
+    {
+        return sha3_update_read(ctx, fd);
+    }
+
+    if (SHA3_OK != sha3_update_mmap(ctx, fd, offset, st.st_size))
+    {
+        return SHA3_ERROR;
+    }
+
+    // leave the descriptor where read() would have
+    lseek(fd, st.st_size, SEEK_SET);
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_fd(sha3_hash_modes_t mode, int fd, uint8_t *output_data)
+{
+    sha3_status_t res = SHA3_OK;
+    sha3_ctx_t ctx;
+
+    if (output_data == NULL)
+    {
+        return SHA3_ERROR;
+    }
+
+    res = sha3_init(mode, &ctx);
+    if (SHA3_OK == res)
+    {
+        res = sha3_update_fd(&ctx, fd);
+    }
+    if (SHA3_OK == res)
+    {
+        res = sha3_final(&ctx, output_data);
+    }
+
+    return res;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_file(sha3_hash_modes_t mode, const char *path, uint8_t *output_data)
+{
+    sha3_status_t res = SHA3_OK;
+    int fd;
+
+    if ( (path == NULL) || (output_data == NULL) )
+    {
+        return SHA3_ERROR;
+    }
+
+    do
+    {
+        fd = open(path, O_RDONLY);
+    } while ( (fd < 0) && (EINTR == errno) );
+
+    if (fd < 0)
+    {
+        return SHA3_ERROR;
+    }
+
+    res = sha3_fd(mode, fd, output_data);
+
+    close(fd);
+
+    return res;
+}
@@ -0,0 +1,153 @@
+/**
+* @file  sha3_internal.h
+* @brief Library internal interfaces shared between the SHA3 modules
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __SHA3_INTERNAL_H_
+#define __SHA3_INTERNAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha3.h"
+#include "sha3_stats.h"
+#include "keccak.h"
+
+/**
+ * Instrumentation, compiled out without SHA3_STATS.
+ */
+#ifdef SHA3_STATS
+extern __thread sha3_stats_t sha3_stats_tls;
+extern sha3_stats_hook_t sha3_stats_begin_hook;
+extern sha3_stats_hook_t sha3_stats_end_hook;
+
+void sha3_stats_emit(sha3_stats_hook_t hook, sha3_stats_op_t op, const void *data, size_t len);
+
+#define SHA3_STATS_ADD(field, n)        (sha3_stats_tls.field += (n))
+#define SHA3_STATS_CALLS(mode, n)       do { if ((uint32_t)(mode) < SHA3_STATS_MODES) \
+                                             sha3_stats_tls.calls[mode] += (n); } while (0)
+#define SHA3_STATS_BEGIN(op, data, len) do { if (NULL != sha3_stats_begin_hook) \
+                                             sha3_stats_emit(sha3_stats_begin_hook, op, data, len); } while (0)
+#define SHA3_STATS_END(op, data, len)   do { if (NULL != sha3_stats_end_hook) \
+                                             sha3_stats_emit(sha3_stats_end_hook, op, data, len); } while (0)
+#else
+#define SHA3_STATS_ADD(field, n)        ((void)0)
+#define SHA3_STATS_CALLS(mode, n)       ((void)0)
+#define SHA3_STATS_BEGIN(op, data, len) ((void)0)
+#define SHA3_STATS_END(op, data, len)   ((void)0)
+#endif
+
+/**
+ * @brief             Irreversibly forgets the sponge output so far
+ *
+ * Zeroes the rate part of the state and permutes: the new state does
+ * not give away anything squeezed before as long as the rate is at
+ * least as wide as the capacity (SHAKE, TurboSHAKE, SHA3-224/256).
+ * ctx is left absorbing at a block
+ * boundary, the next squeeze pads whatever is absorbed in between.
+ *
+ * @param ctx         [in] SHA3 context
+ */
+void sha3_sponge_forget(sha3_ctx_t *ctx);
+
+/**
+ * One message streamed through a lane of a multi-lane Keccak state.
+ */
+typedef struct sha3_lane
+{
+    const uint8_t *input_data;
+    size_t         len;
+    size_t         off;                     // bytes absorbed so far
+    uint8_t       *output_data;
+    uint16_t       bs;                      // rate in bytes
+    uint16_t       d;                       // digest length in bytes
+    uint8_t        pad;
+    uint8_t        final;                   // padded block absorbed
+    uint8_t        done;                    // digest stored
+} sha3_lane_t;
+
+/**
+ * @brief             sha3_hash_many with a head in front of every message
+ *
+ * Message k is head[k] (head_len bytes, up to one rate block of the
+ * mode) followed by input_data[k], e.g. an HMAC pad block or a domain
+ * byte and the data.
+ *
+ * @param mode        [in] SHA3 hash mode
+ * @param head        [in] array of num pointers to head_len bytes each
+ * @param head_len    [in] head length in bytes
+ * @param input_data  [in] array of num pointers to plain data
+ * @param len         [in] array of num plain data lengths in bytes
+ * @param output_data [out] array of num pointers to hash buffers
+ * @param num         [in] number of messages
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_hash_many_head(sha3_hash_modes_t mode,
+                                  const uint8_t *const *head,
+                                  size_t head_len,
+                                  const uint8_t *const *input_data,
+                                  const size_t *len,
+                                  uint8_t *const *output_data,
+                                  uint32_t num);
+
+/**
+ * @brief             Prepares a message for sha3_lanes_step
+ *
+ * Only modes on the full Keccak-f[1600] (SHA3, SHAKE with its default
+ * output length) are accepted, all lanes of a state share the rounds.
+ *
+ * @param lane        [out] lane to set up
+ * @param mode        [in] SHA3 hash mode
+ * @param input_data  [in] message, NULL only when len is 0
+ * @param len         [in] message length in bytes
+ * @param output_data [out] digest buffer of the mode's digest length
+ *
+ * @return            status of operation
+ */
+sha3_status_t sha3_lane_init(sha3_lane_t *lane,
+                             sha3_hash_modes_t mode,
+                             const uint8_t *input_data,
+                             size_t len,
+                             uint8_t *output_data);
+
+/**
+ * @brief             Absorbs one block of every busy lane and permutes
+ *
+ * Lanes whose padded block went in store their digest and are marked
+ * done. Idle lanes are permuted too: clear the state slot of a lane
+ * before a new message starts in it.
+ *
+ * @param impl        [in] multi-lane backend, s holds impl->lanes states
+ * @param s           [in/out] interleaved states s[lanes * i + k]
+ * @param lane        [in/out] impl->lanes lanes, NULL or done ones idle
+ *
+ * @return            number of lanes finished by this step
+ */
+uint32_t sha3_lanes_step(const keccak_impl_t *impl, uint64_t *s, sha3_lane_t *const *lane);
+
+#endif // __SHA3_INTERNAL_H_
@@ -0,0 +1,357 @@
+/**
+* @file  sha3_mb.c
+* @brief Multi-buffer job manager for mixed-length hashing requests
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "sha3_mb.h"
+#include "sha3_internal.h"
+#include "keccak.h"
+
+struct sha3_mb_mgr
+{
+    pthread_mutex_t      lock;
+    pthread_cond_t       work_cv;              // manager waits for jobs
+    pthread_cond_t       done_cv;              // flush waits for completions
+    pthread_t            thread;
+    const keccak_impl_t *impl;                 // fixed for the state layout
+    uint64_t             timeout_ns;
+    sha3_mb_job_t       *head;                 // submitted, not in a lane
+    sha3_mb_job_t       *tail;
+    uint64_t             submitted;
+    uint64_t             done;
+    uint32_t             flushing;             // flush calls waiting
+    uint32_t             stop;
+    sha3_mb_job_t       *completed;            // lock-free stack, newest first
+
+    // manager thread only
+    sha3_mb_job_t       *job[KECCAK_MAX_LANES];
+    sha3_lane_t          lane[KECCAK_MAX_LANES];
+    uint64_t             s[25 * KECCAK_MAX_LANES];
+};
+
+//-------------------------------------------------------
+static uint64_t sha3_mb_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+//-------------------------------------------------------
+static void sha3_mb_complete(sha3_mb_mgr_t *mgr, sha3_mb_job_t *job)
+{
+    sha3_mb_job_t *top;
+
+    job->status = SHA3_OK;
+
+    if (NULL != job->callback)
+    {
+        job->callback(job);
+        return;
+    }
+
+    top = __atomic_load_n(&mgr->completed, __ATOMIC_RELAXED);
+    do
+    {
+        job->next = top;
+    } while (!__atomic_compare_exchange_n(&mgr->completed, &top, job, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Fills idle lanes from the queue, returns the number of busy lanes and
+// the submit time of the oldest job in them; called with the lock held
+//-------------------------------------------------------
+static uint32_t sha3_mb_refill(sha3_mb_mgr_t *mgr, uint64_t *oldest)
+{
+    sha3_mb_job_t *job;
+    uint32_t busy = 0;
+    uint32_t i, k;
+
+    *oldest = UINT64_MAX;
+
+    for(k = 0; k < mgr->impl->lanes; k++)
+    {
+        if ( (NULL == mgr->job[k]) && (NULL != mgr->head) )
+        {
+            job = mgr->head;
+            mgr->head = job->next;
+            if (NULL == mgr->head)
+            {
+                mgr->tail = NULL;
+            }
+
+            // checked on submit, cannot fail
+            sha3_lane_init(&mgr->lane[k], job->mode, job->input_data, job->len, job->output_data);
+            mgr->job[k] = job;
+            SHA3_STATS_CALLS(job->mode, 1);
+
+            // idle lanes are permuted along, start from a clean state
+            for(i = 0; i < 25; i++)
+            {
+                mgr->s[mgr->impl->lanes * i + k] = 0;
+            }
+        }
+
+        if (NULL != mgr->job[k])
+        {
+            busy++;
+            if (mgr->job[k]->submit_ns < *oldest)
+            {
+                *oldest = mgr->job[k]->submit_ns;
+            }
+        }
+    }
+
+    return busy;
+}
+
+//-------------------------------------------------------
+static void *sha3_mb_worker(void *param)
+{
+    sha3_mb_mgr_t *mgr = (sha3_mb_mgr_t *)param;
+    sha3_lane_t *lane[KECCAK_MAX_LANES];
+    sha3_mb_job_t *finished[KECCAK_MAX_LANES];
+    uint32_t lanes = mgr->impl->lanes;
+    uint32_t busy, n, k;
+    uint64_t oldest, deadline;
+    struct timespec ts;
+
+    pthread_mutex_lock(&mgr->lock);
+
+    for(;;)
+    {
+        busy = sha3_mb_refill(mgr, &oldest);
+
+        if (0 == busy)
+        {
+            if (mgr->stop)
+            {
+                break;
+            }
+
+            pthread_cond_wait(&mgr->work_cv, &mgr->lock);
+            continue;
+        }
+
+        // a partly filled set waits for more jobs unless flushed
+        if ( (busy < lanes) && (0 == mgr->flushing) && !mgr->stop && (0 != mgr->timeout_ns) )
+        {
+            deadline = oldest + mgr->timeout_ns;
+            if (sha3_mb_now() < deadline)
+            {
+                ts.tv_sec = (time_t)(deadline / 1000000000u);
+                ts.tv_nsec = (long)(deadline % 1000000000u);
+                pthread_cond_timedwait(&mgr->work_cv, &mgr->lock, &ts);
+                continue;
+            }
+        }
+
+        pthread_mutex_unlock(&mgr->lock);
+
+        for(k = 0; k < lanes; k++)
+        {
+            lane[k] = (NULL != mgr->job[k]) ? &mgr->lane[k] : NULL;
+        }
+
+        // run until a lane frees up, then refill it
+        while (0 == sha3_lanes_step(mgr->impl, mgr->s, lane))
+        {
+        }
+
+        n = 0;
+        for(k = 0; k < lanes; k++)
+        {
+            if ( (NULL != lane[k]) && lane[k]->done )
+            {
+                finished[n++] = mgr->job[k];
+                mgr->job[k] = NULL;
+            }
+        }
+
+        for(k = 0; k < n; k++)
+        {
+            sha3_mb_complete(mgr, finished[k]);
+        }
+
+        pthread_mutex_lock(&mgr->lock);
+        mgr->done += n;
+        pthread_cond_broadcast(&mgr->done_cv);
+    }
+
+    pthread_mutex_unlock(&mgr->lock);
+    return NULL;
+}
+
+//-------------------------------------------------------
+sha3_mb_mgr_t *sha3_mb_create(uint32_t timeout_us)
+{
+    sha3_mb_mgr_t *mgr;
+    pthread_condattr_t attr;
+
+    mgr = (sha3_mb_mgr_t *)calloc(1, sizeof(sha3_mb_mgr_t));
+    if (NULL == mgr)
+    {
+        return NULL;
+    }
+
+    mgr->impl = keccak_get_impl();
+    mgr->timeout_ns = (uint64_t)timeout_us * 1000u;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&mgr->lock, NULL);
+    pthread_cond_init(&mgr->work_cv, &attr);
+    pthread_cond_init(&mgr->done_cv, NULL);
+    pthread_condattr_destroy(&attr);
+
+    if (0 != pthread_create(&mgr->thread, NULL, sha3_mb_worker, mgr))
+    {
+        pthread_cond_destroy(&mgr->done_cv);
+        pthread_cond_destroy(&mgr->work_cv);
+        pthread_mutex_destroy(&mgr->lock);
+        free(mgr);
+        return NULL;
+    }
+
+    return mgr;
+}
+
+//-------------------------------------------------------
+void sha3_mb_destroy(sha3_mb_mgr_t *mgr)
+{
+    if (NULL == mgr)
+    {
+        return;
+    }
+
+    // the manager drains the queue before it leaves
+    pthread_mutex_lock(&mgr->lock);
+    mgr->stop = 1;
+    pthread_cond_signal(&mgr->work_cv);
+    pthread_mutex_unlock(&mgr->lock);
+
+    pthread_join(mgr->thread, NULL);
+
+    pthread_cond_destroy(&mgr->done_cv);
+    pthread_cond_destroy(&mgr->work_cv);
+    pthread_mutex_destroy(&mgr->lock);
+    memset(mgr->s, 0, sizeof(mgr->s));
+    free(mgr);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_mb_submit(sha3_mb_mgr_t *mgr, sha3_mb_job_t *job)
+{
+    sha3_lane_t check;
+
+    if ( (NULL == mgr) || (NULL == job) ||
+         (SHA3_OK != sha3_lane_init(&check, job->mode, job->input_data, job->len, job->output_data)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    job->next = NULL;
+    job->status = SHA3_ERROR;
+    job->submit_ns = sha3_mb_now();
+
+    pthread_mutex_lock(&mgr->lock);
+
+    if (NULL == mgr->tail)
+    {
+        mgr->head = job;
+    }
+    else
+    {
+        mgr->tail->next = job;
+    }
+    mgr->tail = job;
+    mgr->submitted++;
+
+    pthread_cond_signal(&mgr->work_cv);
+    pthread_mutex_unlock(&mgr->lock);
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+void sha3_mb_flush(sha3_mb_mgr_t *mgr)
+{
+    uint64_t target;
+
+    if (NULL == mgr)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&mgr->lock);
+
+    target = mgr->submitted;
+    mgr->flushing++;
+    pthread_cond_signal(&mgr->work_cv);
+
+    while (mgr->done < target)
+    {
+        pthread_cond_wait(&mgr->done_cv, &mgr->lock);
+    }
+
+    mgr->flushing--;
+    pthread_mutex_unlock(&mgr->lock);
+}
+
+//-------------------------------------------------------
+sha3_mb_job_t *sha3_mb_poll(sha3_mb_mgr_t *mgr)
+{
+    sha3_mb_job_t *job;
+    sha3_mb_job_t *next;
+    sha3_mb_job_t *list = NULL;
+
+    if (NULL == mgr)
+    {
+        return NULL;
+    }
+
+    // take the whole stack at once (no ABA) and restore completion order
+    job = __atomic_exchange_n(&mgr->completed, NULL, __ATOMIC_ACQUIRE);
+
+    while (NULL != job)
+    {
+        next = job->next;
+        job->next = list;
+        list = job;
+        job = next;
+    }
+
+    return list;
+}
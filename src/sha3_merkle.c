@@ -0,0 +1,413 @@
+/**
+* @file  sha3_merkle.c
+* @brief Merkle tree over SHA3 with incremental leaf updates
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  04.01.2014
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sha3_merkle.h"
+#include "sha3_internal.h"
+#include "sha3_pool.h"
+
+// Domain bytes in front of leaf data and node pairs (as RFC 6962)
+#define MERKLE_LEAF_PREFIX     0x00
+#define MERKLE_NODE_PREFIX     0x01
+
+// Messages hashed by one pool job (several multi-lane batches)
+#define MERKLE_NODES_PER_JOB   64
+
+static const uint8_t merkle_leaf_prefix[1] = { MERKLE_LEAF_PREFIX };
+static const uint8_t merkle_node_prefix[1] = { MERKLE_NODE_PREFIX };
+
+// One level (or the leaves) hashed in parallel
+typedef struct merkle_level
+{
+    sha3_hash_modes_t     mode;
+    uint32_t              d;
+    const uint8_t        *prefix;
+    const uint8_t *const *input_data;          // leaves, NULL for node pairs
+    const size_t         *len;
+    const uint8_t        *pairs;               // level below, children back to back
+    uint8_t              *output_data;         // first node of the level
+    size_t                num;                 // nodes hashed (odd tail excluded)
+} merkle_level_t;
+
+//-------------------------------------------------------
+static sha3_status_t merkle_digest_len(sha3_hash_modes_t mode, uint32_t *d)
+{
+    switch(mode)
+    {
+        case SHA3_224:
+            *d = SHA3_224_HASH_LEN;
+            break;
+        case SHA3_256:
+            *d = SHA3_256_HASH_LEN;
+            break;
+        case SHA3_384:
+            *d = SHA3_384_HASH_LEN;
+            break;
+        case SHA3_512:
+            *d = SHA3_512_HASH_LEN;
+            break;
+        default:
+            return SHA3_ERROR;
+    }
+
+    return SHA3_OK;
+}
+
+// Node counts and offsets of every level above leaves
+//-------------------------------------------------------
+static uint32_t merkle_shape(size_t leaves, size_t *count, size_t *offset)
+{
+    uint32_t levels = 1;
+
+    count[0] = leaves;
+    offset[0] = 0;
+
+    while (count[levels - 1] > 1)
+    {
+        count[levels] = (count[levels - 1] + 1) / 2;
+        offset[levels] = offset[levels - 1] + count[levels - 1];
+        levels++;
+    }
+
+    return levels;
+}
+
+//-------------------------------------------------------
+static void merkle_hash_leaf(sha3_hash_modes_t mode, const uint8_t *data, size_t len, uint8_t *output_data)
+{
+    sha3_ctx_t ctx;
+
+    sha3_init(mode, &ctx);
+    sha3_update(&ctx, merkle_leaf_prefix, sizeof(merkle_leaf_prefix));
+    sha3_update(&ctx, data, len);
+    sha3_final(&ctx, output_data);
+}
+
+//-------------------------------------------------------
+static void merkle_hash_node(sha3_hash_modes_t mode,
+                             uint32_t d,
+                             const uint8_t *left,
+                             const uint8_t *right,
+                             uint8_t *output_data)
+{
+    sha3_ctx_t ctx;
+
+    sha3_init(mode, &ctx);
+    sha3_update(&ctx, merkle_node_prefix, sizeof(merkle_node_prefix));
+    sha3_update(&ctx, left, d);
+    sha3_update(&ctx, right, d);
+    sha3_final(&ctx, output_data);
+}
+
+// MERKLE_NODES_PER_JOB nodes of a level through the multi-lane kernel
+//-------------------------------------------------------
+static void merkle_job(void *arg, uint32_t index)
+{
+    const merkle_level_t *level = (const merkle_level_t *)arg;
+    const uint8_t *head[MERKLE_NODES_PER_JOB];
+    const uint8_t *in[MERKLE_NODES_PER_JOB];
+    uint8_t *out[MERKLE_NODES_PER_JOB];
+    size_t len[MERKLE_NODES_PER_JOB];
+    size_t first = (size_t)index * MERKLE_NODES_PER_JOB;
+    uint32_t n, i;
+
+    n = (level->num - first > MERKLE_NODES_PER_JOB) ? MERKLE_NODES_PER_JOB : (uint32_t)(level->num - first);
+
+    for(i = 0; i < n; i++)
+    {
+        head[i] = level->prefix;
+        out[i] = level->output_data + (first + i) * level->d;
+
+        if (NULL != level->input_data)
+        {
+            in[i] = level->input_data[first + i];
+            len[i] = level->len[first + i];
+        }
+        else
+        {
+            // left and right children are adjacent in the level below
+            in[i] = level->pairs + (first + i) * 2 * level->d;
+            len[i] = 2 * (size_t)level->d;
+        }
+    }
+
+    sha3_hash_many_head(level->mode, head, 1, in, len, out, n);
+}
+
+//-------------------------------------------------------
+static void merkle_run_level(merkle_level_t *level)
+{
+    size_t jobs = (level->num + MERKLE_NODES_PER_JOB - 1) / MERKLE_NODES_PER_JOB;
+
+    if (jobs > 1)
+    {
+        sha3_pool_run((uint32_t)jobs, merkle_job, level);
+    }
+    else if (jobs == 1)
+    {
+        merkle_job(level, 0);
+    }
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_merkle_init(sha3_merkle_t *tree, sha3_hash_modes_t mode, size_t leaves)
+{
+    uint32_t d;
+
+    if ( (NULL == tree) || (0 == leaves) || (leaves > SIZE_MAX / 2 / SHA3_512_HASH_LEN) ||
+         (SHA3_OK != merkle_digest_len(mode, &d)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    memset(tree, 0, sizeof(sha3_merkle_t));
+
+    tree->mode = mode;
+    tree->d = d;
+    tree->leaves = leaves;
+    tree->levels = merkle_shape(leaves, tree->count, tree->offset);
+
+    // fewer than 2 * leaves nodes in all
+    tree->nodes = (uint8_t *)calloc(tree->offset[tree->levels - 1] + 1, d);
+    if (NULL == tree->nodes)
+    {
+        return SHA3_ERROR;
+    }
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+void sha3_merkle_free(sha3_merkle_t *tree)
+{
+    if (NULL != tree)
+    {
+        free(tree->nodes);
+        tree->nodes = NULL;
+    }
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_merkle_build(sha3_merkle_t *tree,
+                                const uint8_t *const *leaf_data,
+                                const size_t *leaf_len)
+{
+    merkle_level_t level;
+    uint8_t *below;
+    uint8_t *above;
+    size_t i;
+    uint32_t l;
+
+    if ( (NULL == tree) || (NULL == tree->nodes) || (NULL == leaf_data) || (NULL == leaf_len) )
+    {
+        return SHA3_ERROR;
+    }
+
+    for(i = 0; i < tree->leaves; i++)
+    {
+        if ( (NULL == leaf_data[i]) && (leaf_len[i] != 0) )
+        {
+            return SHA3_ERROR;
+        }
+    }
+
+    level.mode = tree->mode;
+    level.d = tree->d;
+    level.prefix = merkle_leaf_prefix;
+    level.input_data = leaf_data;
+    level.len = leaf_len;
+    level.pairs = NULL;
+    level.output_data = tree->nodes;
+    level.num = tree->leaves;
+    merkle_run_level(&level);
+
+    // every level depends on the whole level below
+    level.prefix = merkle_node_prefix;
+    level.input_data = NULL;
+    level.len = NULL;
+
+    for(l = 1; l < tree->levels; l++)
+    {
+        below = tree->nodes + tree->offset[l - 1] * tree->d;
+        above = tree->nodes + tree->offset[l] * tree->d;
+
+        level.pairs = below;
+        level.output_data = above;
+        level.num = tree->count[l - 1] / 2;
+        merkle_run_level(&level);
+
+        if (tree->count[l - 1] & 1)
+        {
+            memcpy(above + level.num * tree->d, below + 2 * level.num * tree->d, tree->d);
+        }
+    }
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_merkle_update(sha3_merkle_t *tree, size_t index, const uint8_t *data, size_t len)
+{
+    uint8_t *below;
+    uint8_t *above;
+    uint32_t l;
+
+    if ( (NULL == tree) || (NULL == tree->nodes) || (index >= tree->leaves) ||
+         ( (NULL == data) && (len != 0) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    merkle_hash_leaf(tree->mode, data, len, tree->nodes + index * tree->d);
+
+    for(l = 1; l < tree->levels; l++)
+    {
+        below = tree->nodes + (tree->offset[l - 1] + (index & ~(size_t)1)) * tree->d;
+        above = tree->nodes + (tree->offset[l] + index / 2) * tree->d;
+
+        if ((index | 1) < tree->count[l - 1])
+        {
+            merkle_hash_node(tree->mode, tree->d, below, below + tree->d, above);
+        }
+        else
+        {
+            memcpy(above, below, tree->d);
+        }
+
+        index /= 2;
+    }
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_merkle_root(const sha3_merkle_t *tree, uint8_t *output_data)
+{
+    if ( (NULL == tree) || (NULL == tree->nodes) || (NULL == output_data) )
+    {
+        return SHA3_ERROR;
+    }
+
+    memcpy(output_data, tree->nodes + tree->offset[tree->levels - 1] * tree->d, tree->d);
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_merkle_proof(const sha3_merkle_t *tree,
+                                size_t index,
+                                uint8_t *proof,
+                                uint32_t *proof_num)
+{
+    uint32_t num = 0;
+    uint32_t l;
+
+    if ( (NULL == tree) || (NULL == tree->nodes) || (index >= tree->leaves) ||
+         (NULL == proof) || (NULL == proof_num) )
+    {
+        return SHA3_ERROR;
+    }
+
+    for(l = 0; l + 1 < tree->levels; l++)
+    {
+        if ((index ^ 1) < tree->count[l])
+        {
+            memcpy(proof + num * tree->d, tree->nodes + (tree->offset[l] + (index ^ 1)) * tree->d, tree->d);
+            num++;
+        }
+
+        index /= 2;
+    }
+
+    *proof_num = num;
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_merkle_verify(sha3_hash_modes_t mode,
+                                 const uint8_t *root,
+                                 size_t leaves,
+                                 size_t index,
+                                 const uint8_t *data,
+                                 size_t len,
+                                 const uint8_t *proof,
+                                 uint32_t proof_num)
+{
+    size_t count[SHA3_MERKLE_MAX_LEVELS];
+    size_t offset[SHA3_MERKLE_MAX_LEVELS];
+    uint8_t node[SHA3_512_HASH_LEN];
+    uint32_t levels, used = 0;
+    uint32_t d, l;
+
+    if ( (NULL == root) || (index >= leaves) || ( (NULL == data) && (len != 0) ) ||
+         ( (NULL == proof) && (proof_num != 0) ) ||
+         (SHA3_OK != merkle_digest_len(mode, &d)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    levels = merkle_shape(leaves, count, offset);
+
+    merkle_hash_leaf(mode, data, len, node);
+
+    for(l = 0; l + 1 < levels; l++)
+    {
+        if ((index ^ 1) < count[l])
+        {
+            if (used == proof_num)
+            {
+                return SHA3_ERROR;
+            }
+
+            if (index & 1)
+            {
+                merkle_hash_node(mode, d, proof + used * d, node, node);
+            }
+            else
+            {
+                merkle_hash_node(mode, d, node, proof + used * d, node);
+            }
+            used++;
+        }
+
+        index /= 2;
+    }
+
+    if ( (used != proof_num) || (0 != memcmp(node, root, d)) )
+    {
+        return SHA3_ERROR;
+    }
+
+    return SHA3_OK;
+}
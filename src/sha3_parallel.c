@@ -0,0 +1,401 @@
+/**
+* @file  sha3_parallel.c
+* @brief Tree hashing modes (ParallelHash, KangarooTwelve) on the multi-lane
+*        kernels and worker pool
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sha3.h"
+#include "sha3_pool.h"
+
+// Leaves hashed by one pool job (one or more multi-lane batches)
+#define TREE_LEAVES_PER_JOB      16
+
+// Jobs per window of chaining values, per thread
+#define TREE_JOBS_PER_THREAD     4
+
+// Below this many leaves threads cost more than they save
+#define TREE_PARALLEL_MIN_LEAVES (2 * TREE_LEAVES_PER_JOB)
+
+// Largest chaining value
+#define TREE_MAX_CV_LEN          64
+
+// KangarooTwelve domain bytes: single node, final node, leaf
+#define K12_DOMAIN_SINGLE        0x07
+#define K12_DOMAIN_FINAL         0x06
+#define K12_DOMAIN_LEAF          0x0B
+
+static const uint8_t ph_name[] =
+{
+    'P', 'a', 'r', 'a', 'l', 'l', 'e', 'l', 'H', 'a', 's', 'h'
+};
+
+static const uint8_t k12_leaves_marker[8] = { 0x03, 0, 0, 0, 0, 0, 0, 0 };
+static const uint8_t k12_final_marker[2] = { 0xFF, 0xFF };
+
+// Window of leaves hashed in parallel
+typedef struct tree_window
+{
+    sha3_hash_modes_t mode;
+    uint8_t           domain;                  // TurboSHAKE leaf domain, 0 for SHAKE leaves
+    const uint8_t    *input_data;              // first byte of leaf 0
+    size_t            len;
+    size_t            block_size;
+    size_t            first;                   // first leaf of the window
+    size_t            end;                     // leaf after the window
+    uint32_t          cv_len;
+    uint8_t          *cv;                      // chaining values of the window
+} tree_window_t;
+
+// Chaining values of TREE_LEAVES_PER_JOB leaves
+//-------------------------------------------------------
+static void tree_job(void *arg, uint32_t index)
+{
+    const tree_window_t *w = (const tree_window_t *)arg;
+    const uint8_t *in[TREE_LEAVES_PER_JOB];
+    uint8_t *out[TREE_LEAVES_PER_JOB];
+    size_t len[TREE_LEAVES_PER_JOB];
+    size_t leaf = w->first + (size_t)index * TREE_LEAVES_PER_JOB;
+    size_t n = w->end - leaf;
+    uint32_t i;
+
+    if (n > TREE_LEAVES_PER_JOB)
+    {
+        n = TREE_LEAVES_PER_JOB;
+    }
+
+    for(i = 0; i < n; i++)
+    {
+        in[i] = w->input_data + (leaf + i) * w->block_size;
+        len[i] = w->len - (leaf + i) * w->block_size;
+        if (len[i] > w->block_size)
+        {
+            len[i] = w->block_size;
+        }
+        out[i] = w->cv + (leaf + i - w->first) * w->cv_len;
+    }
+
+    if (w->domain != 0)
+    {
+        sha3_turboshake_many(w->mode, w->domain, in, len, out, w->cv_len, n);
+    }
+    else
+    {
+        // SHAKE default output length is the ParallelHash chaining value
+        sha3_hash_many(w->mode, in, len, out, n);
+    }
+}
+
+// Hash 'leaves' leaves window by window and absorb their chaining
+// values into ctx in leaf order. Small inputs stay on the calling
+// thread and the stack.
+//-------------------------------------------------------
+static sha3_status_t tree_absorb_leaves(sha3_ctx_t *ctx, tree_window_t *w, size_t leaves)
+{
+    uint8_t cv_stack[TREE_LEAVES_PER_JOB * TREE_MAX_CV_LEN];
+    sha3_status_t res = SHA3_OK;
+    size_t window;
+    uint32_t threads, jobs;
+
+    w->cv = cv_stack;
+    window = TREE_LEAVES_PER_JOB;
+    threads = sha3_pool_threads();
+    if ( (threads > 1) && (leaves >= TREE_PARALLEL_MIN_LEAVES) )
+    {
+        window = TREE_LEAVES_PER_JOB * TREE_JOBS_PER_THREAD * threads;
+        w->cv = (uint8_t *)malloc(window * w->cv_len);
+        if (NULL == w->cv)
+        {
+            window = TREE_LEAVES_PER_JOB;
+            w->cv = cv_stack;
+        }
+    }
+
+    for(w->first = 0; (SHA3_OK == res) && (w->first < leaves); w->first = w->end)
+    {
+        w->end = (leaves - w->first > window) ? w->first + window : leaves;
+        jobs = (uint32_t)((w->end - w->first + TREE_LEAVES_PER_JOB - 1) / TREE_LEAVES_PER_JOB);
+
+        if (w->cv == cv_stack)
+        {
+            tree_job(w, 0);
+        }
+        else
+        {
+            sha3_pool_run(jobs, tree_job, w);
+        }
+
+        res = sha3_update(ctx, w->cv, (w->end - w->first) * w->cv_len);
+    }
+
+    if (w->cv != cv_stack)
+    {
+        free(w->cv);
+    }
+
+    return res;
+}
+
+//-------------------------------------------------------
+void sha3_set_threads(uint32_t threads)
+{
+    sha3_pool_set_threads(threads);
+}
+
+//-------------------------------------------------------
+sha3_status_t PARALLELHASH(sha3_hash_modes_t mode,
+                           const uint8_t *input_data,
+                           size_t len,
+                           size_t block_size,
+                           const uint8_t *custom,
+                           size_t custom_len,
+                           uint8_t *output_data,
+                           size_t output_len)
+{
+    uint8_t enc[SHA3_ENCODE_MAX_LEN];
+    sha3_status_t res = SHA3_OK;
+    sha3_ctx_t ctx;
+    tree_window_t w;
+    size_t leaves;
+    uint32_t n;
+
+    if ( (input_data == NULL) || (output_data == NULL) || (0 == block_size) ||
+         ( (SHAKE128 != mode) && (SHAKE256 != mode) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    if (SHA3_OK != sha3_cshake_init(mode, &ctx, ph_name, sizeof(ph_name), custom, custom_len))
+    {
+        return SHA3_ERROR;
+    }
+
+    leaves = len / block_size + ((len % block_size) ? 1 : 0);
+
+    w.mode = mode;
+    w.domain = 0;
+    w.input_data = input_data;
+    w.len = len;
+    w.block_size = block_size;
+    w.cv_len = (SHAKE128 == mode) ? SHAKE128_HASH_LEN : SHAKE256_HASH_LEN;
+
+    // z = left_encode(B) || CV_0 || ... || CV_n-1 || right_encode(n) || right_encode(L)
+    n = sha3_left_encode(block_size, enc);
+    res = sha3_update(&ctx, enc, n);
+
+    if (SHA3_OK == res)
+    {
+        res = tree_absorb_leaves(&ctx, &w, leaves);
+    }
+    if (SHA3_OK == res)
+    {
+        n = sha3_right_encode(leaves, enc);
+        res = sha3_update(&ctx, enc, n);
+    }
+    if (SHA3_OK == res)
+    {
+        n = sha3_right_encode((uint64_t)output_len * 8, enc);
+        res = sha3_update(&ctx, enc, n);
+    }
+    if (SHA3_OK == res)
+    {
+        res = sha3_squeeze(&ctx, output_data, output_len);
+    }
+
+    return res;
+}
+
+// KangarooTwelve length_encode: big-endian bytes without leading zeros
+// followed by their count
+//-------------------------------------------------------
+static uint32_t k12_length_encode(uint64_t x, uint8_t *output_data)
+{
+    uint32_t n = 0;
+    uint32_t i;
+
+    while ( (n < 8) && (x >> (8 * n)) )
+    {
+        n++;
+    }
+
+    for(i = 0; i < n; i++)
+    {
+        output_data[i] = (uint8_t)(x >> (8 * (n - 1 - i)));
+    }
+    output_data[n] = (uint8_t)n;
+
+    return n + 1;
+}
+
+// Absorb bytes [from, to) of S = part[0] || part[1] || part[2]
+//-------------------------------------------------------
+static sha3_status_t k12_update_range(sha3_ctx_t *ctx,
+                                      const uint8_t *const part[3],
+                                      const size_t part_len[3],
+                                      uint64_t from,
+                                      uint64_t to)
+{
+    uint64_t base = 0;
+    uint64_t a, b;
+    uint32_t i;
+
+    for(i = 0; i < 3; i++)
+    {
+        a = (from > base) ? from : base;
+        b = (to < base + part_len[i]) ? to : base + part_len[i];
+
+        if ( (a < b) && (SHA3_OK != sha3_update(ctx, part[i] + (a - base), (size_t)(b - a))) )
+        {
+            return SHA3_ERROR;
+        }
+
+        base += part_len[i];
+    }
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t KANGAROOTWELVE(sha3_hash_modes_t mode,
+                             const uint8_t *input_data,
+                             size_t len,
+                             const uint8_t *custom,
+                             size_t custom_len,
+                             uint8_t *output_data,
+                             size_t output_len)
+{
+    uint8_t enc[SHA3_ENCODE_MAX_LEN];
+    uint8_t cv[TREE_MAX_CV_LEN];
+    const uint8_t *part[3];
+    size_t part_len[3];
+    sha3_status_t res = SHA3_OK;
+    sha3_ctx_t ctx;
+    sha3_ctx_t leaf_ctx;
+    tree_window_t w;
+    uint64_t total, chunks, i;
+    size_t direct;
+    uint32_t n;
+
+    if ( (input_data == NULL) || (output_data == NULL) ||
+         ( (NULL == custom) && (custom_len != 0) ) ||
+         ( (TURBOSHAKE128 != mode) && (TURBOSHAKE256 != mode) ) )
+    {
+        return SHA3_ERROR;
+    }
+
+    // S = M || C || length_encode(|C|)
+    part[0] = input_data;
+    part_len[0] = len;
+    part[1] = custom;
+    part_len[1] = custom_len;
+    part[2] = enc;
+    part_len[2] = k12_length_encode(custom_len, enc);
+    total = (uint64_t)len + custom_len + part_len[2];
+
+    if (total <= K12_CHUNK_LEN)
+    {
+        res = sha3_turboshake_init(mode, &ctx, K12_DOMAIN_SINGLE);
+        if (SHA3_OK == res)
+        {
+            res = k12_update_range(&ctx, part, part_len, 0, total);
+        }
+        if (SHA3_OK == res)
+        {
+            res = sha3_squeeze(&ctx, output_data, output_len);
+        }
+        return res;
+    }
+
+    // Final node: S_0 || 03 00 00 00 00 00 00 00 || CV_1 .. CV_n-1 ||
+    // length_encode(n - 1) || FF FF
+    chunks = (total + K12_CHUNK_LEN - 1) / K12_CHUNK_LEN;
+
+    res = sha3_turboshake_init(mode, &ctx, K12_DOMAIN_FINAL);
+    if (SHA3_OK == res)
+    {
+        res = k12_update_range(&ctx, part, part_len, 0, K12_CHUNK_LEN);
+    }
+    if (SHA3_OK == res)
+    {
+        res = sha3_update(&ctx, k12_leaves_marker, sizeof(k12_leaves_marker));
+    }
+
+    // Chunks lying completely in M are hashed in parallel straight from
+    // the caller's buffer
+    direct = (len >= K12_CHUNK_LEN) ? len / K12_CHUNK_LEN - 1 : 0;
+
+    w.mode = mode;
+    w.domain = K12_DOMAIN_LEAF;
+    w.input_data = input_data + K12_CHUNK_LEN;
+    w.len = direct * K12_CHUNK_LEN;
+    w.block_size = K12_CHUNK_LEN;
+    w.cv_len = (TURBOSHAKE128 == mode) ? SHAKE128_HASH_LEN : SHAKE256_HASH_LEN;
+
+    if (SHA3_OK == res)
+    {
+        res = tree_absorb_leaves(&ctx, &w, direct);
+    }
+
+    // The rest touch C or its encoding
+    for(i = direct + 1; (SHA3_OK == res) && (i < chunks); i++)
+    {
+        res = sha3_turboshake_init(mode, &leaf_ctx, K12_DOMAIN_LEAF);
+        if (SHA3_OK == res)
+        {
+            res = k12_update_range(&leaf_ctx, part, part_len, i * K12_CHUNK_LEN,
+                                   (i + 1) * K12_CHUNK_LEN < total ? (i + 1) * K12_CHUNK_LEN : total);
+        }
+        if (SHA3_OK == res)
+        {
+            res = sha3_squeeze(&leaf_ctx, cv, w.cv_len);
+        }
+        if (SHA3_OK == res)
+        {
+            res = sha3_update(&ctx, cv, w.cv_len);
+        }
+    }
+
+    if (SHA3_OK == res)
+    {
+        n = k12_length_encode(chunks - 1, enc);
+        res = sha3_update(&ctx, enc, n);
+    }
+    if (SHA3_OK == res)
+    {
+        res = sha3_update(&ctx, k12_final_marker, sizeof(k12_final_marker));
+    }
+    if (SHA3_OK == res)
+    {
+        res = sha3_squeeze(&ctx, output_data, output_len);
+    }
+
+    return res;
+}
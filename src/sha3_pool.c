@@ -0,0 +1,243 @@
+/**
+* @file  sha3_pool.c
+* @brief Internal worker pool for parallel hashing modes
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "sha3_pool.h"
+
+#define SHA3_POOL_MAX_THREADS 256
+
+typedef struct sha3_pool
+{
+    pthread_mutex_t lock;
+    pthread_cond_t  work_cv;                   // workers wait for a new task
+    pthread_cond_t  done_cv;                   // caller waits for the workers
+    pthread_mutex_t run_lock;                  // one task at a time
+    uint32_t        want;                      // configured threads, caller included
+    uint32_t        started;                   // worker threads running
+    uint64_t        generation;                // bumped for every task
+    sha3_pool_fn_t  fn;
+    void           *arg;
+    uint32_t        num;
+    uint32_t        next;                      // next job index, atomic
+    uint32_t        busy;                      // workers inside the task
+} sha3_pool_t;
+
+static sha3_pool_t sha3_pool =
+{
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER,
+    0, 0, 0, NULL, NULL, 0, 0, 0
+};
+
+static pthread_once_t sha3_pool_once = PTHREAD_ONCE_INIT;
+
+// Only the forking thread lives on in the child: forget the workers and
+// whatever locks other threads held, the child starts its own on demand.
+//-------------------------------------------------------
+static void sha3_pool_atfork_child(void)
+{
+    sha3_pool_t *pool = &sha3_pool;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+    pthread_mutex_init(&pool->run_lock, NULL);
+    pool->started = 0;
+    pool->generation = 0;
+    pool->fn = NULL;
+    pool->arg = NULL;
+    pool->num = 0;
+    pool->next = 0;
+    pool->busy = 0;
+}
+
+static void sha3_pool_register(void)
+{
+    pthread_atfork(NULL, NULL, sha3_pool_atfork_child);
+}
+
+//-------------------------------------------------------
+static void sha3_pool_take_jobs(sha3_pool_t *pool)
+{
+    uint32_t index;
+
+    while ( (index = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < pool->num )
+    {
+        pool->fn(pool->arg, index);
+    }
+}
+
+//-------------------------------------------------------
+static void *sha3_pool_worker(void *param)
+{
+    sha3_pool_t *pool = &sha3_pool;
+    uint32_t id = (uint32_t)(uintptr_t)param;
+    uint64_t seen;
+
+    // Workers are started right before the generation bump of the task
+    // that already counts them in busy, and that task cannot finish
+    // without them: the first generation seen here is theirs.
+    pthread_mutex_lock(&pool->lock);
+    seen = pool->generation - 1;
+
+    for(;;)
+    {
+        while (pool->generation == seen)
+        {
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        }
+        seen = pool->generation;
+
+        // workers above the configured count sit the task out
+        if (id + 1 >= pool->want)
+        {
+            continue;
+        }
+
+        pthread_mutex_unlock(&pool->lock);
+        sha3_pool_take_jobs(pool);
+        pthread_mutex_lock(&pool->lock);
+
+        if (0 == --pool->busy)
+        {
+            pthread_cond_signal(&pool->done_cv);
+        }
+    }
+
+    return NULL;
+}
+
+//-------------------------------------------------------
+static uint32_t sha3_pool_default_threads(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (n < 1)
+    {
+        return 1;
+    }
+
+    return (n > SHA3_POOL_MAX_THREADS) ? SHA3_POOL_MAX_THREADS : (uint32_t)n;
+}
+
+//-------------------------------------------------------
+uint32_t sha3_pool_threads(void)
+{
+    uint32_t want;
+
+    pthread_mutex_lock(&sha3_pool.lock);
+    if (0 == sha3_pool.want)
+    {
+        sha3_pool.want = sha3_pool_default_threads();
+    }
+    want = sha3_pool.want;
+    pthread_mutex_unlock(&sha3_pool.lock);
+
+    return want;
+}
+
+//-------------------------------------------------------
+void sha3_pool_set_threads(uint32_t threads)
+{
+    if (0 == threads)
+    {
+        threads = sha3_pool_default_threads();
+    }
+
+    if (threads > SHA3_POOL_MAX_THREADS)
+    {
+        threads = SHA3_POOL_MAX_THREADS;
+    }
+
+    // wait for a running task, it counted the workers with the old value
+    pthread_mutex_lock(&sha3_pool.run_lock);
+    pthread_mutex_lock(&sha3_pool.lock);
+    sha3_pool.want = threads;
+    pthread_mutex_unlock(&sha3_pool.lock);
+    pthread_mutex_unlock(&sha3_pool.run_lock);
+}
+
+//-------------------------------------------------------
+void sha3_pool_run(uint32_t num, sha3_pool_fn_t fn, void *arg)
+{
+    sha3_pool_t *pool = &sha3_pool;
+    pthread_t thread;
+    uint32_t i;
+
+    if ( (num < 2) || (sha3_pool_threads() < 2) ||
+         (0 != pthread_mutex_trylock(&pool->run_lock)) )
+    {
+        for(i = 0; i < num; i++)
+        {
+            fn(arg, i);
+        }
+        return;
+    }
+
+    // before the first worker exists, a child forked later resets the pool
+    pthread_once(&sha3_pool_once, sha3_pool_register);
+
+    pthread_mutex_lock(&pool->lock);
+
+    while (pool->started < pool->want - 1)
+    {
+        if (0 != pthread_create(&thread, NULL, sha3_pool_worker, (void *)(uintptr_t)pool->started))
+        {
+            break;
+        }
+        pthread_detach(thread);
+        pool->started++;
+    }
+
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->num = num;
+    pool->next = 0;
+    pool->busy = (pool->started < pool->want - 1) ? pool->started : pool->want - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    sha3_pool_take_jobs(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy != 0)
+    {
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->run_lock);
+}
@@ -0,0 +1,65 @@
+/**
+* @file  sha3_pool.h
+* @brief Internal worker pool for parallel hashing modes.
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef __SHA3_POOL_H_
+#define __SHA3_POOL_H_
+
+#include <stdint.h>
+
+/**
+ * Job callback, processes job number index.
+ */
+typedef void (*sha3_pool_fn_t)(void *arg, uint32_t index);
+
+/**
+ * @brief          Runs fn(arg, 0) .. fn(arg, num - 1) on the worker pool
+ *
+ * The calling thread takes jobs too and the call returns once all of
+ * them are done. Worker threads are started on first use. If the pool
+ * is busy with another caller the jobs run on the calling thread.
+ *
+ * @param num      [in] number of jobs
+ * @param fn       [in] job callback
+ * @param arg      [in] callback argument
+ */
+void sha3_pool_run(uint32_t num, sha3_pool_fn_t fn, void *arg);
+
+/**
+ * @brief          Number of threads (including the caller) used for jobs
+ */
+uint32_t sha3_pool_threads(void);
+
+/**
+ * @brief          Sets the number of threads used for jobs
+ *
+ * @param threads  [in] thread count, 0 for one per online CPU
+ */
+void sha3_pool_set_threads(uint32_t threads);
+
+#endif // __SHA3_POOL_H_
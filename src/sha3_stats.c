@@ -0,0 +1,124 @@
+/**
+* @file  sha3_stats.c
+* @brief Optional per-thread counters and timing hooks
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "sha3_stats.h"
+#include "sha3_internal.h"
+
+#ifdef SHA3_STATS
+
+__thread sha3_stats_t sha3_stats_tls;
+
+sha3_stats_hook_t sha3_stats_begin_hook;
+sha3_stats_hook_t sha3_stats_end_hook;
+void             *sha3_stats_hook_arg;
+
+//-------------------------------------------------------
+void sha3_stats_emit(sha3_stats_hook_t hook, sha3_stats_op_t op, const void *data, size_t len)
+{
+    sha3_stats_event_t event;
+#if defined(__x86_64__) || defined(__i386__)
+    event.tsc = __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    event.tsc = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+    event.op = op;
+    event.data = data;
+    event.len = len;
+
+    hook(sha3_stats_hook_arg, &event);
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_stats_snapshot(sha3_stats_t *stats)
+{
+    if (NULL == stats)
+    {
+        return SHA3_ERROR;
+    }
+
+    *stats = sha3_stats_tls;
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_stats_reset(void)
+{
+    memset(&sha3_stats_tls, 0, sizeof(sha3_stats_tls));
+
+    return SHA3_OK;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_stats_set_hooks(sha3_stats_hook_t begin, sha3_stats_hook_t end, void *arg)
+{
+    sha3_stats_hook_arg = arg;
+    sha3_stats_begin_hook = begin;
+    sha3_stats_end_hook = end;
+
+    return SHA3_OK;
+}
+
+#else
+
+//-------------------------------------------------------
+sha3_status_t sha3_stats_snapshot(sha3_stats_t *stats)
+{
+    (void)stats;
+    return SHA3_ERROR;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_stats_reset(void)
+{
+    return SHA3_ERROR;
+}
+
+//-------------------------------------------------------
+sha3_status_t sha3_stats_set_hooks(sha3_stats_hook_t begin, sha3_stats_hook_t end, void *arg)
+{
+    (void)begin;
+    (void)end;
+    (void)arg;
+    return SHA3_ERROR;
+}
+
+#endif // SHA3_STATS
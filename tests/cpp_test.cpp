@@ -0,0 +1,229 @@
+/*
+ ============================================================================
+ Name        : cpp_test.cpp
+ Author      : Sergii Sidorov
+ Version     : 1.0.0
+ Copyright   : Your copyright notice
+ Description : Tests of the header-only C++ interface
+ ============================================================================
+ */
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "sha3.hpp"
+#include "tests.h"
+
+namespace {
+
+std::uint8_t input[1000];
+
+// hasher<Mode> against the C one-shot for every length, fed in pieces
+template <sha3_hash_modes_t Mode>
+bool hpp_mode_test()
+{
+    using hasher = sha3::hasher<Mode>;
+    std::uint8_t ref[512];
+    sha3::hasher<Mode> h;
+
+    static_assert(hasher::digest_size <= sizeof(ref), "reference buffer");
+
+    for (std::size_t len = 0; len < sizeof(input); len += 7)
+    {
+        h.reset();
+        h.update(input, len / 3).update(nullptr, 0).update(input + len / 3, len - len / 3);
+
+        if constexpr (hasher::xof)
+        {
+            if (hasher::rounds == KECCAK_ROUNDS)
+            {
+                SHAKE(Mode, input, len, ref, 500);
+            }
+            else
+            {
+                TURBOSHAKE(Mode, 0x1F, input, len, ref, 500);
+            }
+
+            auto out = h.template finalize<500>();
+            if (std::memcmp(out.data(), ref, out.size()))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            SHA3(Mode, input, len, ref);
+
+            auto out = h.finalize();
+            if (std::memcmp(out.data(), ref, out.size()))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Keccak-f[1600] of the zero state, hash IDs evaluated by the compiler
+static_assert(sha3::keccak_p({})[0] == 0xF1258F7940E1DDE7ULL, "constexpr permutation");
+static_assert(sha3::id64<SHA3_256>("abc") == 0xb225e24fa75d983aULL, "constexpr SHA3-256");
+static_assert(sha3::id64<SHA3_256>("") == 0x66d71ebff8c6ffa7ULL, "constexpr SHA3-256");
+
+// 300 bytes, more than one block of every mode
+constexpr std::array<std::uint8_t, 300> ptn_array()
+{
+    std::array<std::uint8_t, 300> a = {};
+
+    for (std::size_t i = 0; i < a.size(); i++)
+    {
+        a[i] = (std::uint8_t)(i % 251);
+    }
+
+    return a;
+}
+
+int route(std::string_view name)
+{
+    switch (sha3::id64(name))
+    {
+        case sha3::id64("order.new"):    return 1;
+        case sha3::id64("order.cancel"): return 2;
+        default:                         return 0;
+    }
+}
+
+} // namespace
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_constexpr_test(void)
+{
+    constexpr std::string_view fox = "The quick brown fox jumps over the lazy dog";
+    constexpr auto table = ptn_array();
+    constexpr auto fox_224 = sha3::digest<SHA3_224>(fox);
+    constexpr auto fox_512 = sha3::digest<SHA3_512>(fox);
+    constexpr auto table_256 = sha3::digest<SHA3_256>(table);
+    constexpr auto table_384 = sha3::digest<SHA3_384>(table);
+    constexpr auto table_shake = sha3::digest<SHAKE128, 400>(table);
+    constexpr auto table_turbo = sha3::digest<TURBOSHAKE256, 200>(table);
+    std::uint8_t ref[400];
+    std::array<std::uint64_t, 25> s = {};
+    std::uint64_t t[25];
+    std::uint32_t rounds;
+
+    // permutation against the table driven runtime kernel
+    for (rounds = 12; rounds <= KECCAK_ROUNDS; rounds += 12)
+    {
+        for (std::size_t i = 0; i < 25; i++)
+        {
+            s[i] = 0x0123456789ABCDEFULL * (i + rounds);
+            t[i] = s[i];
+        }
+
+        s = sha3::keccak_p(s, rounds);
+        keccak_fn(t, rounds);
+
+        if (std::memcmp(s.data(), t, sizeof(t)))
+        {
+            print_test_result(0, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    SHA3(SHA3_224, (const std::uint8_t *)fox.data(), fox.size(), ref);
+    if (std::memcmp(fox_224.data(), ref, fox_224.size()))
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    SHA3(SHA3_512, (const std::uint8_t *)fox.data(), fox.size(), ref);
+    if (std::memcmp(fox_512.data(), ref, fox_512.size()))
+    {
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    SHA3(SHA3_256, table.data(), table.size(), ref);
+    if (std::memcmp(table_256.data(), ref, table_256.size()))
+    {
+        print_test_result(3, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    SHA3(SHA3_384, table.data(), table.size(), ref);
+    if (std::memcmp(table_384.data(), ref, table_384.size()))
+    {
+        print_test_result(4, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    SHAKE(SHAKE128, table.data(), table.size(), ref, table_shake.size());
+    if (std::memcmp(table_shake.data(), ref, table_shake.size()))
+    {
+        print_test_result(5, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    TURBOSHAKE(TURBOSHAKE256, 0x1F, table.data(), table.size(), ref, table_turbo.size());
+    if (std::memcmp(table_turbo.data(), ref, table_turbo.size()))
+    {
+        print_test_result(6, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    if ( (1 != route("order.new")) || (2 != route("order.cancel")) || (0 != route("order.old")) )
+    {
+        print_test_result(7, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(8, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_hpp_test(void)
+{
+    const std::uint8_t abc_reference[SHA3_256_HASH_LEN] =
+    {
+        0x3a, 0x98, 0x5d, 0xa7, 0x4f, 0xe2, 0x25, 0xb2,
+        0x04, 0x5c, 0x17, 0x2d, 0x6b, 0xd3, 0x90, 0xbd,
+        0x85, 0x5f, 0x08, 0x6e, 0x3e, 0x9d, 0x52, 0x5b,
+        0x46, 0xbf, 0xe2, 0x45, 0x11, 0x43, 0x15, 0x32
+    };
+    std::uint8_t ref[SHAKE128_HASH_LEN];
+
+    for (std::size_t i = 0; i < sizeof(input); i++)
+    {
+        input[i] = (std::uint8_t)(i % 251);
+    }
+
+    static_assert(sha3::sha3_256::rate == 136 && sha3::sha3_512::digest_size == 64, "mode constants");
+
+    if (std::memcmp(sha3::sha3_256::hash(std::string_view("abc")).data(), abc_reference, sizeof(abc_reference)))
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    if ( !hpp_mode_test<SHA3_224>() || !hpp_mode_test<SHA3_256>() ||
+         !hpp_mode_test<SHA3_384>() || !hpp_mode_test<SHA3_512>() ||
+         !hpp_mode_test<SHAKE128>() || !hpp_mode_test<SHAKE256>() ||
+         !hpp_mode_test<TURBOSHAKE128>() || !hpp_mode_test<TURBOSHAKE256>() )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    // TurboSHAKE domain byte
+    TURBOSHAKE(TURBOSHAKE128, 0x0B, input, 100, ref, sizeof(ref));
+    if (std::memcmp(sha3::turboshake128(0x0B).update(input, 100).finalize().data(), ref, sizeof(ref)))
+    {
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(3, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
@@ -0,0 +1,1564 @@
+/*
+ ============================================================================
+ Name        : func_test.c
+ Author      : Sergii Sidorov
+ Version     : 1.0.0
+ Copyright   : Your copyright notice
+ Description : SHA3 functional tests of the extended APIs
+ ============================================================================
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include "sha3.h"
+#include "kmac_sha3.h"
+#include "hmac_sha3.h"
+#include "sha3_mb.h"
+#include "sha3_merkle.h"
+#include "sha3_stats.h"
+#include "sha3_drbg.h"
+#include "sha3_aead.h"
+#include "tests.h"
+
+#define FUNC_TEST_MAX_LEN  700
+#define FUNC_TEST_MSGS     11
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_hash_many_test(sha3_hash_modes_t sha3_mode)
+{
+    // Batches mixing empty, short, exactly-rate and multi-block messages
+    static uint8_t input[FUNC_TEST_MAX_LEN];
+    uint8_t output[FUNC_TEST_MSGS][SHA3_512_HASH_LEN];
+    uint8_t output_ref[SHA3_512_HASH_LEN];
+    const uint8_t *in[FUNC_TEST_MSGS];
+    uint8_t *out[FUNC_TEST_MSGS];
+    size_t len[FUNC_TEST_MSGS];
+    uint32_t d;
+    uint32_t base, i;
+
+    d = (SHA3_224 == sha3_mode) ? SHA3_224_HASH_LEN :
+        (SHA3_256 == sha3_mode) ? SHA3_256_HASH_LEN :
+        (SHA3_384 == sha3_mode) ? SHA3_384_HASH_LEN : SHA3_512_HASH_LEN;
+
+    for(i = 0; i < sizeof(input); i++)
+    {
+        input[i] = (uint8_t)(i * 13 + 1);
+    }
+
+    for(base = 0; base + 60 * FUNC_TEST_MSGS < FUNC_TEST_MAX_LEN * 2; base += 17)
+    {
+        for(i = 0; i < FUNC_TEST_MSGS; i++)
+        {
+            len[i] = (base + i * 61) % FUNC_TEST_MAX_LEN;
+            in[i] = input + (i % 3);
+            out[i] = output[i];
+            if (in[i] + len[i] > input + sizeof(input))
+            {
+                len[i] = (size_t)(input + sizeof(input) - in[i]);
+            }
+        }
+        // an empty message may come without a buffer at all
+        in[FUNC_TEST_MSGS - 1] = NULL;
+        len[FUNC_TEST_MSGS - 1] = 0;
+
+        if ( (SHA3_OK != sha3_hash_x4(sha3_mode, in, len, out)) ||
+             (SHA3_OK != sha3_hash_many(sha3_mode, in, len, out, FUNC_TEST_MSGS)) )
+        {
+            print_test_result(base, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+
+        for(i = 0; i < FUNC_TEST_MSGS; i++)
+        {
+            SHA3(sha3_mode, (NULL == in[i]) ? input : in[i], len[i], output_ref);
+            if (memcmp(output_ref, output[i], d))
+            {
+                print_test_result(base, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+        }
+    }
+
+    print_test_result(base, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_shake_test(void)
+{
+    const uint8_t input_str[] = "The quick brown fox jumps over the lazy dog";
+
+    // SHAKE256(""), 64 bytes
+    const uint8_t output_reference_shake256[SHAKE256_HASH_LEN] =
+    {
+        0x46, 0xb9, 0xdd, 0x2b, 0x0b, 0xa8, 0x8d, 0x13,
+        0x23, 0x3b, 0x3f, 0xeb, 0x74, 0x3e, 0xeb, 0x24,
+        0x3f, 0xcd, 0x52, 0xea, 0x62, 0xb8, 0x1b, 0x82,
+        0xb5, 0x0c, 0x27, 0x64, 0x6e, 0xd5, 0x76, 0x2f,
+        0xd7, 0x5d, 0xc4, 0xdd, 0xd8, 0xc0, 0xf2, 0x00,
+        0xcb, 0x05, 0x01, 0x9d, 0x67, 0xb5, 0x92, 0xf6,
+        0xfc, 0x82, 0x1c, 0x49, 0x47, 0x9a, 0xb4, 0x86,
+        0x40, 0x29, 0x2e, 0xac, 0xb3, 0xb7, 0xc4, 0xbe
+    };
+
+    // SHAKE128(input_str), output bytes 1000..1031
+    const uint8_t output_reference_shake128[32] =
+    {
+        0xf2, 0xcc, 0x26, 0x93, 0xe0, 0x0c, 0x1f, 0xf8,
+        0xb1, 0xb2, 0x5c, 0xea, 0x7f, 0x22, 0xa5, 0x9b,
+        0x56, 0x01, 0x8c, 0xcc, 0xfc, 0x80, 0xd7, 0xe5,
+        0x81, 0xf6, 0xb5, 0xd1, 0x50, 0xe9, 0x57, 0xac
+    };
+
+    static uint8_t output_ref[1032];
+    static uint8_t output_str[1032];
+    uint8_t output[SHAKE256_HASH_LEN];
+    sha3_ctx_t ctx;
+    uint32_t chunk, pos, n;
+
+    if ( (SHA3_OK != SHAKE(SHAKE256, input_str, 0, output, sizeof(output))) ||
+         memcmp(output_reference_shake256, output, sizeof(output)) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    // sha3_final returns the default output length
+    sha3_init(SHAKE256, &ctx);
+    if ( (SHA3_OK != sha3_final(&ctx, output)) ||
+         memcmp(output_reference_shake256, output, sizeof(output)) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    if ( (SHA3_OK != SHAKE(SHAKE128, input_str, (uint32_t)strlen((const char *)input_str),
+                           output_ref, sizeof(output_ref))) ||
+         memcmp(output_reference_shake128, output_ref + 1000, sizeof(output_reference_shake128)) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    // the output stream does not depend on how it is split into calls
+    for(chunk = 1; chunk <= 200; chunk++)
+    {
+        sha3_init(SHAKE128, &ctx);
+        sha3_update(&ctx, input_str, (uint32_t)strlen((const char *)input_str));
+
+        for(pos = 0; pos < sizeof(output_str); pos += n)
+        {
+            n = sizeof(output_str) - pos;
+            if (n > chunk)
+            {
+                n = chunk;
+            }
+            sha3_squeeze(&ctx, output_str + pos, n);
+        }
+
+        if ( memcmp(output_ref, output_str, sizeof(output_str)) ||
+             (SHA3_ERROR != sha3_update(&ctx, input_str, 1)) )
+        {
+            print_test_result(chunk, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    print_test_result(chunk, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t kmac_sha3_test(void)
+{
+    // SP 800-185 samples: cSHAKE128 #1, KMAC128 #1, #2 and KMAC256 #2
+    static const uint8_t custom_str[] = "My Tagged Application";
+    static const uint8_t email_str[] = "Email Signature";
+    const uint8_t output_reference_cshake128[32] =
+    {
+        0xc1, 0xc3, 0x69, 0x25, 0xb6, 0x40, 0x9a, 0x04,
+        0xf1, 0xb5, 0x04, 0xfc, 0xbc, 0xa9, 0xd8, 0x2b,
+        0x40, 0x17, 0x27, 0x7c, 0xb5, 0xed, 0x2b, 0x20,
+        0x65, 0xfc, 0x1d, 0x38, 0x14, 0xd5, 0xaa, 0xf5
+    };
+    const uint8_t output_reference_kmac128[32] =
+    {
+        0xe5, 0x78, 0x0b, 0x0d, 0x3e, 0xa6, 0xf7, 0xd3,
+        0xa4, 0x29, 0xc5, 0x70, 0x6a, 0xa4, 0x3a, 0x00,
+        0xfa, 0xdb, 0xd7, 0xd4, 0x96, 0x28, 0x83, 0x9e,
+        0x31, 0x87, 0x24, 0x3f, 0x45, 0x6e, 0xe1, 0x4e
+    };
+    const uint8_t output_reference_kmac128_s[32] =
+    {
+        0x3b, 0x1f, 0xba, 0x96, 0x3c, 0xd8, 0xb0, 0xb5,
+        0x9e, 0x8c, 0x1a, 0x6d, 0x71, 0x88, 0x8b, 0x71,
+        0x43, 0x65, 0x1a, 0xf8, 0xba, 0x0a, 0x70, 0x70,
+        0xc0, 0x97, 0x9e, 0x28, 0x11, 0x32, 0x4a, 0xa5
+    };
+    const uint8_t output_reference_kmac256_s[KMAC_SHA3_256_LEN] =
+    {
+        0xb5, 0x86, 0x18, 0xf7, 0x1f, 0x92, 0xe1, 0xd5,
+        0x6c, 0x1b, 0x8c, 0x55, 0xdd, 0xd7, 0xcd, 0x18,
+        0x8b, 0x97, 0xb4, 0xca, 0x4d, 0x99, 0x83, 0x1e,
+        0xb2, 0x69, 0x9a, 0x83, 0x7d, 0xa2, 0xe4, 0xd9,
+        0x70, 0xfb, 0xac, 0xfd, 0xe5, 0x00, 0x33, 0xae,
+        0xa5, 0x85, 0xf1, 0xa2, 0x70, 0x85, 0x10, 0xc3,
+        0x2d, 0x07, 0x88, 0x08, 0x01, 0xbd, 0x18, 0x28,
+        0x98, 0xfe, 0x47, 0x68, 0x76, 0xfc, 0x89, 0x65
+    };
+    uint8_t key[32];
+    uint8_t input[200];
+    uint8_t output[KMAC_SHA3_256_LEN];
+    kmac_sha3_ctx_t ctx;
+    uint32_t i;
+
+    for(i = 0; i < sizeof(key); i++)
+    {
+        key[i] = (uint8_t)(0x40 + i);
+    }
+
+    for(i = 0; i < sizeof(input); i++)
+    {
+        input[i] = (uint8_t)i;
+    }
+
+    if ( (SHA3_OK != CSHAKE(SHAKE128, input, 4, NULL, 0, email_str, sizeof(email_str) - 1, output, 32)) ||
+         memcmp(output_reference_cshake128, output, 32) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    if ( (KMAC_SHA3_OK != KMAC_SHA3(KMAC_SHA3_128, input, 4, key, sizeof(key), NULL, 0, output, 32)) ||
+         memcmp(output_reference_kmac128, output, 32) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    if ( (KMAC_SHA3_OK != KMAC_SHA3(KMAC_SHA3_128, input, 4, key, sizeof(key),
+                                    custom_str, sizeof(custom_str) - 1, output, 32)) ||
+         memcmp(output_reference_kmac128_s, output, 32) )
+    {
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    // streaming, one byte at a time
+    kmac_sha3_init(KMAC_SHA3_256, &ctx, key, sizeof(key), custom_str, sizeof(custom_str) - 1);
+    for(i = 0; i < sizeof(input); i++)
+    {
+        kmac_sha3_update(&ctx, input + i, 1);
+    }
+
+    if ( (KMAC_SHA3_OK != kmac_sha3_final(&ctx, output, KMAC_SHA3_256_LEN)) ||
+         memcmp(output_reference_kmac256_s, output, KMAC_SHA3_256_LEN) )
+    {
+        print_test_result(3, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(4, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t parallelhash_test(void)
+{
+    // SP 800-185 ParallelHash128 samples #1, #2 and a ParallelHash256
+    // input large enough for the worker pool
+    static const uint8_t custom_str[] = "Parallel Data";
+    const uint8_t output_reference_ph128[32] =
+    {
+        0xba, 0x8d, 0xc1, 0xd1, 0xd9, 0x79, 0x33, 0x1d,
+        0x3f, 0x81, 0x36, 0x03, 0xc6, 0x7f, 0x72, 0x60,
+        0x9a, 0xb5, 0xe4, 0x4b, 0x94, 0xa0, 0xb8, 0xf9,
+        0xaf, 0x46, 0x51, 0x44, 0x54, 0xa2, 0xb4, 0xf5
+    };
+    const uint8_t output_reference_ph128_s[32] =
+    {
+        0xfc, 0x48, 0x4d, 0xcb, 0x3f, 0x84, 0xdc, 0xee,
+        0xdc, 0x35, 0x34, 0x38, 0x15, 0x1b, 0xee, 0x58,
+        0x15, 0x7d, 0x6e, 0xfe, 0xd0, 0x44, 0x5a, 0x81,
+        0xf1, 0x65, 0xe4, 0x95, 0x79, 0x5b, 0x72, 0x06
+    };
+    const uint8_t output_reference_ph256_s[64] =
+    {
+        0xf4, 0x67, 0xcf, 0x19, 0x58, 0xa3, 0xbb, 0xd7,
+        0x87, 0x1b, 0x06, 0x6c, 0x26, 0x39, 0x14, 0x7a,
+        0x82, 0xac, 0x4c, 0x12, 0xa2, 0xb2, 0xd3, 0xd8,
+        0x8d, 0xe2, 0x6d, 0xf0, 0xc6, 0x73, 0x7a, 0x1f,
+        0xba, 0xc0, 0x12, 0xfa, 0x15, 0xc6, 0xec, 0xbf,
+        0x10, 0x9a, 0x6e, 0x72, 0x5b, 0x0d, 0xdf, 0xe1,
+        0x77, 0x50, 0x24, 0xec, 0x05, 0xda, 0x39, 0xc6,
+        0x31, 0xd6, 0x3d, 0x84, 0xcd, 0x63, 0xaf, 0x53
+    };
+    static uint8_t input[100003];
+    uint8_t output[64];
+    uint32_t threads;
+    uint32_t i;
+
+    for(i = 0; i < 24; i++)
+    {
+        input[i] = (uint8_t)((i / 8) * 0x10 + i % 8);
+    }
+
+    if ( (SHA3_OK != PARALLELHASH(SHAKE128, input, 24, 8, NULL, 0, output, 32)) ||
+         memcmp(output_reference_ph128, output, 32) ||
+         (SHA3_OK != PARALLELHASH(SHAKE128, input, 24, 8, custom_str, sizeof(custom_str) - 1, output, 32)) ||
+         memcmp(output_reference_ph128_s, output, 32) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(i = 0; i < sizeof(input); i++)
+    {
+        input[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    for(threads = 1; threads <= 4; threads++)
+    {
+        sha3_set_threads(threads);
+
+        if ( (SHA3_OK != PARALLELHASH(SHAKE256, input, sizeof(input), 1000,
+                                      custom_str, sizeof(custom_str) - 1, output, 64)) ||
+             memcmp(output_reference_ph256_s, output, 64) )
+        {
+            sha3_set_threads(0);
+            print_test_result(threads, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    sha3_set_threads(0);
+    print_test_result(threads, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+static void ptn_fill(uint8_t *buf, uint32_t len)
+{
+    uint32_t i;
+
+    for(i = 0; i < len; i++)
+    {
+        buf[i] = (uint8_t)(i % 251);
+    }
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t kangarootwelve_test(void)
+{
+    // RFC 9861 style vectors, ptn(n) = 00 01 .. FA repeated
+    const uint8_t output_reference_ts128[32] =                  // TurboSHAKE128("", 1F)
+    {
+        0x1e, 0x41, 0x5f, 0x1c, 0x59, 0x83, 0xaf, 0xf2,
+        0x16, 0x92, 0x17, 0x27, 0x7d, 0x17, 0xbb, 0x53,
+        0x8c, 0xd9, 0x45, 0xa3, 0x97, 0xdd, 0xec, 0x54,
+        0x1f, 0x1c, 0xe4, 0x1a, 0xf2, 0xc1, 0xb7, 0x4c
+    };
+    const uint8_t output_reference_ts256[64] =                  // TurboSHAKE256(ptn(17^2), 06)
+    {
+        0xf9, 0x84, 0xb1, 0x41, 0xdc, 0xf8, 0x91, 0x04,
+        0xeb, 0x82, 0x7b, 0x3f, 0xcf, 0x15, 0xd8, 0x73,
+        0x28, 0x7d, 0x9b, 0x01, 0x41, 0x44, 0x4e, 0x63,
+        0x8b, 0x9a, 0xca, 0xc9, 0x53, 0x9e, 0x1f, 0x26,
+        0xa4, 0xc3, 0x12, 0x8b, 0x79, 0x0f, 0x90, 0x70,
+        0x66, 0xf4, 0xef, 0xc0, 0x11, 0x7d, 0x80, 0x7e,
+        0xe3, 0x02, 0x7c, 0xa2, 0xd5, 0x49, 0xcf, 0x83,
+        0xf0, 0xcc, 0x36, 0x5b, 0x45, 0x37, 0x0f, 0xe3
+    };
+    const uint8_t output_reference_kt128[32] =                  // KT128(ptn(17^4), "")
+    {
+        0x87, 0x01, 0x04, 0x5e, 0x22, 0x20, 0x53, 0x45,
+        0xff, 0x4d, 0xda, 0x05, 0x55, 0x5c, 0xbb, 0x5c,
+        0x3a, 0xf1, 0xa7, 0x71, 0xc2, 0xb8, 0x9b, 0xae,
+        0xf3, 0x7d, 0xb4, 0x3d, 0x99, 0x98, 0xb9, 0xfe
+    };
+    const uint8_t output_reference_kt128_c[32] =                // KT128(ptn(8191), ptn(41))
+    {
+        0xbc, 0x07, 0xe7, 0xa3, 0xce, 0x4f, 0x2f, 0x7c,
+        0xe2, 0x74, 0x6b, 0xe7, 0xe2, 0x23, 0xe1, 0x75,
+        0xab, 0x69, 0x8b, 0x47, 0xfc, 0x2b, 0xdc, 0x33,
+        0x2a, 0x31, 0x79, 0x9a, 0xe4, 0x8b, 0xa0, 0xbe
+    };
+    const uint8_t output_reference_kt256_c[64] =                // KT256(ptn(300000), ptn(41^2))
+    {
+        0x4d, 0xb3, 0xc0, 0xbc, 0xda, 0x77, 0x31, 0xf0,
+        0xc6, 0xc0, 0xaa, 0x83, 0x34, 0x58, 0x35, 0xa0,
+        0x35, 0x4d, 0x2a, 0xb1, 0x7c, 0x0e, 0xc9, 0x6a,
+        0x3f, 0xef, 0x55, 0x21, 0xf3, 0x2b, 0x8b, 0x3b,
+        0x99, 0xe4, 0xf3, 0x26, 0x88, 0xc7, 0x30, 0x20,
+        0x7f, 0x05, 0x10, 0x05, 0x22, 0xd7, 0x8c, 0x41,
+        0xea, 0xf1, 0x6c, 0x28, 0x81, 0x26, 0x0c, 0x7a,
+        0x93, 0xa2, 0x01, 0x0c, 0xfa, 0x1f, 0xb0, 0x32
+    };
+    const uint8_t output_reference_kt128_big[32] =              // KT128(ptn(600000), "")
+    {
+        0xe7, 0xd3, 0xee, 0x89, 0x03, 0xce, 0x51, 0xe6,
+        0x3d, 0x4c, 0x5b, 0xcf, 0x53, 0x86, 0x51, 0xa9,
+        0xf3, 0xca, 0xe0, 0xdc, 0xc0, 0x0c, 0x0e, 0x71,
+        0x01, 0x2d, 0x08, 0x68, 0xe1, 0xf6, 0x8c, 0x6d
+    };
+    static uint8_t input[600000];
+    static uint8_t custom[41 * 41];
+    uint8_t output[64];
+    uint32_t threads;
+
+    ptn_fill(input, sizeof(input));
+    ptn_fill(custom, sizeof(custom));
+
+    if ( (SHA3_OK != TURBOSHAKE(TURBOSHAKE128, 0x1F, input, 0, output, 32)) ||
+         memcmp(output_reference_ts128, output, 32) ||
+         (SHA3_OK != TURBOSHAKE(TURBOSHAKE256, 0x06, input, 17 * 17, output, 64)) ||
+         memcmp(output_reference_ts256, output, 64) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    if ( (SHA3_OK != KANGAROOTWELVE(TURBOSHAKE128, input, 17 * 17 * 17 * 17, NULL, 0, output, 32)) ||
+         memcmp(output_reference_kt128, output, 32) ||
+         (SHA3_OK != KANGAROOTWELVE(TURBOSHAKE128, input, 8191, custom, 41, output, 32)) ||
+         memcmp(output_reference_kt128_c, output, 32) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(threads = 1; threads <= 4; threads++)
+    {
+        sha3_set_threads(threads);
+
+        if ( (SHA3_OK != KANGAROOTWELVE(TURBOSHAKE256, input, 300000, custom, sizeof(custom), output, 64)) ||
+             memcmp(output_reference_kt256_c, output, 64) ||
+             (SHA3_OK != KANGAROOTWELVE(TURBOSHAKE128, input, sizeof(input), NULL, 0, output, 32)) ||
+             memcmp(output_reference_kt128_big, output, 32) )
+        {
+            sha3_set_threads(0);
+            print_test_result(threads, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    sha3_set_threads(0);
+    print_test_result(threads, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_pool_fork_test(void)
+{
+    // The worker pool is started in the parent, the child has none of
+    // its threads and must not wait for them
+    static uint8_t input[(1 << 19) + 11];
+    uint8_t ph_ref[32], kt_ref[32];
+    uint8_t ph[32], kt[32];
+    int status = -1;
+    pid_t pid;
+
+    ptn_fill(input, sizeof(input));
+    sha3_set_threads(4);
+
+    if ( (SHA3_OK != PARALLELHASH(SHAKE128, input, sizeof(input), 1024, NULL, 0, ph_ref, sizeof(ph_ref))) ||
+         (SHA3_OK != KANGAROOTWELVE(TURBOSHAKE128, input, sizeof(input), NULL, 0, kt_ref, sizeof(kt_ref))) )
+    {
+        sha3_set_threads(0);
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    fflush(stdout);
+    pid = fork();
+    if (0 == pid)
+    {
+        // a hang ends with SIGALRM
+        alarm(10);
+        if ( (SHA3_OK != PARALLELHASH(SHAKE128, input, sizeof(input), 1024, NULL, 0, ph, sizeof(ph))) ||
+             (SHA3_OK != KANGAROOTWELVE(TURBOSHAKE128, input, sizeof(input), NULL, 0, kt, sizeof(kt))) ||
+             memcmp(ph, ph_ref, sizeof(ph)) || memcmp(kt, kt_ref, sizeof(kt)) )
+        {
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    if (pid > 0)
+    {
+        waitpid(pid, &status, 0);
+    }
+    sha3_set_threads(0);
+
+    if ( (pid < 0) || !WIFEXITED(status) || (0 != WEXITSTATUS(status)) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(2, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t hmac_sha3_test(void)
+{
+    // Same results as Python hmac with SHA3 (block size is the rate)
+    static const uint8_t fox_str[] = "The quick brown fox jumps over the lazy dog";
+    const uint8_t output_reference_256[SHA3_256_HMAC_LEN] =     // key 00..13, "Hi There"
+    {
+        0xf0, 0x63, 0x1b, 0x58, 0xc3, 0x36, 0x03, 0x5b,
+        0xa7, 0xd4, 0x23, 0x5c, 0xf4, 0x7b, 0x91, 0xd6,
+        0xe6, 0xa0, 0x59, 0x84, 0xbd, 0xed, 0x9c, 0xd5,
+        0xdb, 0x86, 0xb0, 0x70, 0x10, 0xd0, 0x1e, 0x87
+    };
+    const uint8_t output_reference_512[SHA3_512_HMAC_LEN] =     // key aa x 200, fox
+    {
+        0x09, 0x2d, 0x7d, 0xfd, 0xea, 0x43, 0x8b, 0x85,
+        0x3d, 0x0a, 0x54, 0x22, 0x1a, 0xbd, 0x25, 0xec,
+        0x79, 0x31, 0x55, 0x7e, 0xd8, 0x8f, 0x87, 0x70,
+        0x3a, 0xc8, 0xc1, 0x18, 0xdb, 0x84, 0xa7, 0x1d,
+        0x78, 0x97, 0x0c, 0x92, 0xd7, 0xc8, 0x39, 0xdb,
+        0x3d, 0x9c, 0x1a, 0x0a, 0xfe, 0xb0, 0x0e, 0x31,
+        0x16, 0x80, 0xd1, 0xdb, 0x39, 0xc4, 0xa4, 0x01,
+        0xbe, 0x94, 0xd4, 0x84, 0xaf, 0x4d, 0x11, 0x94
+    };
+    const uint8_t output_reference_224[2][SHA3_224_HMAC_LEN] =  // key aa x 144 and x 145, fox
+    {
+        {
+            0x3a, 0x02, 0x07, 0x0c, 0xbf, 0xf7, 0xdc, 0x91,
+            0x75, 0x61, 0xa3, 0xb0, 0xd1, 0x03, 0x68, 0xfd,
+            0x73, 0x14, 0xf7, 0x90, 0xbd, 0x8a, 0x9e, 0x63,
+            0x37, 0xbe, 0x52, 0x84
+        },
+        {
+            0x43, 0x66, 0x0b, 0x52, 0x28, 0x93, 0xfd, 0x7c,
+            0x81, 0xa4, 0xec, 0xb0, 0x48, 0x24, 0xed, 0x84,
+            0x43, 0xc2, 0x8c, 0x8c, 0x74, 0x23, 0xa9, 0x54,
+            0xfe, 0xc8, 0xe4, 0x6d
+        }
+    };
+    uint8_t key[200];
+    uint8_t output[SHA3_512_HMAC_LEN];
+    hmac_sha3_ctx_t ctx;
+    uint32_t i;
+
+    for(i = 0; i < 20; i++)
+    {
+        key[i] = (uint8_t)i;
+    }
+
+    if ( (HMAC_SHA3_OK != HMAC_SHA3(HMAC_SHA3_256, (const uint8_t *)"Hi There", 8, key, 20, output)) ||
+         memcmp(output_reference_256, output, SHA3_256_HMAC_LEN) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    memset(key, 0xaa, sizeof(key));
+
+    // key of exactly one block is used as is, one byte more is hashed
+    for(i = 0; i < 2; i++)
+    {
+        if ( (HMAC_SHA3_OK != HMAC_SHA3(HMAC_SHA3_224, fox_str, sizeof(fox_str) - 1, key, 144 + i, output)) ||
+             memcmp(output_reference_224[i], output, SHA3_224_HMAC_LEN) )
+        {
+            print_test_result(1, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    // one keyed context reused for several messages
+    if (HMAC_SHA3_OK != hmac_sha3_init(HMAC_SHA3_512, &ctx, key, sizeof(key)))
+    {
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(i = 0; i < 3; i++)
+    {
+        hmac_sha3_update(&ctx, (const uint8_t *)"garbage", 7);
+        hmac_sha3_reset(&ctx);
+        hmac_sha3_update(&ctx, fox_str, 10);
+        hmac_sha3_update(&ctx, fox_str + 10, sizeof(fox_str) - 11);
+
+        if ( (HMAC_SHA3_OK != hmac_sha3_final(&ctx, output)) ||
+             memcmp(output_reference_512, output, SHA3_512_HMAC_LEN) ||
+             (HMAC_SHA3_OK != hmac_sha3_reset(&ctx)) )
+        {
+            print_test_result(3, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    print_test_result(4, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t hmac_sha3_verify_many_test(hmac_sha3_hash_mode_t hmac_mode)
+{
+    // keys around the block size, every fifth tag corrupted, odd count
+    static const size_t key_lens[] = { 0, 20, 144, 145, 300 };
+    static uint8_t key[310];
+    static uint8_t input[1000];
+    static uint8_t tags[37][SHA3_512_HMAC_LEN];
+    const uint8_t *key_ptr[37];
+    const uint8_t *input_ptr[37];
+    const uint8_t *tag_ptr[37];
+    size_t key_len[37];
+    size_t len[37];
+    uint8_t result[(37 + 7) / 8];
+    size_t tag_len = (HMAC_SHA3_224 == hmac_mode) ? SHA3_224_HMAC_LEN :
+                     (HMAC_SHA3_256 == hmac_mode) ? SHA3_256_HMAC_LEN :
+                     (HMAC_SHA3_384 == hmac_mode) ? SHA3_384_HMAC_LEN : SHA3_512_HMAC_LEN;
+    uint32_t i;
+
+    ptn_fill(key, sizeof(key));
+    ptn_fill(input, sizeof(input));
+
+    for(i = 0; i < 37; i++)
+    {
+        key_ptr[i] = key + i % 7;
+        key_len[i] = key_lens[i % 5] - ((i % 5) == 4 ? i % 7 : 0);
+        input_ptr[i] = input + i;
+        len[i] = (i * 29) % (sizeof(input) - 37);
+        tag_ptr[i] = tags[i];
+
+        if (HMAC_SHA3_OK != HMAC_SHA3(hmac_mode, input_ptr[i], len[i], key_ptr[i], key_len[i], tags[i]))
+        {
+            print_test_result(0, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+
+        if (0 == (i % 5))
+        {
+            tags[i][i % tag_len] ^= 0x01;
+        }
+    }
+
+    if (HMAC_SHA3_OK != hmac_sha3_verify_many(hmac_mode, key_ptr, key_len, input_ptr, len,
+                                              tag_ptr, tag_len, result, 37))
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(i = 0; i < 37; i++)
+    {
+        if (((result[i / 8] >> (i % 8)) & 1) != (0 != (i % 5)))
+        {
+            print_test_result(2, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    // truncated tags compare the MAC prefix only
+    if ( (HMAC_SHA3_OK != hmac_sha3_verify_many(hmac_mode, key_ptr + 5, key_len + 5, input_ptr + 5, len + 5,
+                                                tag_ptr + 5, 5, result, 1)) ||
+         (result[0] != 1) ||
+         (HMAC_SHA3_ERROR != hmac_sha3_verify_many(hmac_mode, key_ptr, key_len, input_ptr, len,
+                                                   tag_ptr, tag_len + 1, result, 37)) )
+    {
+        print_test_result(3, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(4, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_file_test(void)
+{
+    // mmap path from an unaligned offset, read() path over a pipe
+    static uint8_t input[(1 << 20) + 4097];
+    char path[] = "/tmp/sha3_file_test_XXXXXX";
+    uint8_t output[SHA3_512_HASH_LEN];
+    uint8_t output_ref[SHA3_512_HASH_LEN];
+    int pipe_fd[2];
+    int fd;
+    sha3_test_result_t res = SHA3_TEST_PASSED;
+
+    ptn_fill(input, sizeof(input));
+
+    fd = mkstemp(path);
+    if ( (fd < 0) || (write(fd, input, sizeof(input)) != (ssize_t)sizeof(input)) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    SHA3(SHA3_256, input, sizeof(input), output_ref);
+    if ( (SHA3_OK != sha3_file(SHA3_256, path, output)) ||
+         memcmp(output_ref, output, SHA3_256_HASH_LEN) )
+    {
+        res = SHA3_TEST_FAILS;
+    }
+
+    SHA3(SHA3_512, input + 4099, sizeof(input) - 4099, output_ref);
+    if ( (SHA3_TEST_PASSED == res) &&
+         ( (lseek(fd, 4099, SEEK_SET) != 4099) ||
+           (SHA3_OK != sha3_fd(SHA3_512, fd, output)) ||
+           memcmp(output_ref, output, SHA3_512_HASH_LEN) ||
+           (lseek(fd, 0, SEEK_CUR) != (off_t)sizeof(input)) ) )
+    {
+        res = SHA3_TEST_FAILS;
+    }
+
+    close(fd);
+    unlink(path);
+
+    if ( (SHA3_TEST_PASSED != res) || (SHA3_OK == sha3_file(SHA3_256, path, output)) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    // fits into the pipe buffer, no writer thread needed
+    SHA3(SHA3_384, input, 5000, output_ref);
+    if ( (0 != pipe(pipe_fd)) || (write(pipe_fd[1], input, 5000) != 5000) )
+    {
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+    close(pipe_fd[1]);
+
+    if ( (SHA3_OK != sha3_fd(SHA3_384, pipe_fd[0], output)) ||
+         memcmp(output_ref, output, SHA3_384_HASH_LEN) )
+    {
+        res = SHA3_TEST_FAILS;
+    }
+    close(pipe_fd[0]);
+
+    print_test_result(3, res);
+    return res;
+}
+
+//---------------------------------------------------------------------
+typedef struct
+{
+    int            fd;
+    const uint8_t *data;
+    size_t         len;
+} sha3_pipe_test_writer_t;
+
+// Writes in uneven chunks, the pipe end is closed at the end
+static void *sha3_pipe_test_writer(void *arg)
+{
+    sha3_pipe_test_writer_t *w = (sha3_pipe_test_writer_t *)arg;
+    size_t off = 0, n;
+    ssize_t res;
+
+    while (off < w->len)
+    {
+        n = 1 + (off * 7919) % 70001;
+        n = (n > w->len - off) ? w->len - off : n;
+        res = write(w->fd, w->data + off, n);
+        if (res <= 0)
+        {
+            break;
+        }
+        off += (size_t)res;
+    }
+
+    close(w->fd);
+    return NULL;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_pipe_test(void)
+{
+    // reader thread over a pipe, small ring to exercise backpressure
+    static uint8_t input[(3 << 20) + 137];
+    char path[] = "/tmp/sha3_pipe_test_XXXXXX";
+    uint8_t output[SHA3_256_HASH_LEN];
+    uint8_t output_ref[SHA3_256_HASH_LEN];
+    sha3_pipe_test_writer_t w;
+    pthread_t writer;
+    sha3_ctx_t ctx;
+    int pipe_fd[2], tee_pipe[2];
+    int tee_fd;
+    sha3_status_t res;
+
+    ptn_fill(input, sizeof(input));
+    SHA3(SHA3_256, input, sizeof(input), output_ref);
+
+    tee_fd = mkstemp(path);
+    if ( (tee_fd < 0) || (0 != pipe(pipe_fd)) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    w.fd = pipe_fd[1];
+    w.data = input;
+    w.len = sizeof(input);
+    pthread_create(&writer, NULL, sha3_pipe_test_writer, &w);
+
+    sha3_init(SHA3_256, &ctx);
+    res = sha3_update_fd_pipelined(&ctx, pipe_fd[0], tee_fd, 2, 5000);
+    sha3_final(&ctx, output);
+    pthread_join(writer, NULL);
+    close(pipe_fd[0]);
+    close(tee_fd);
+
+    // the copy has to be the same bytes
+    if ( (SHA3_OK != res) || memcmp(output_ref, output, sizeof(output)) ||
+         (SHA3_OK != sha3_file(SHA3_256, path, output)) || memcmp(output_ref, output, sizeof(output)) )
+    {
+        unlink(path);
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+    unlink(path);
+
+    // default ring, data already in the pipe
+    SHA3(SHA3_256, input, 1000, output_ref);
+    if ( (0 != pipe(pipe_fd)) || (write(pipe_fd[1], input, 1000) != 1000) )
+    {
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+    close(pipe_fd[1]);
+
+    sha3_init(SHA3_256, &ctx);
+    res = sha3_update_fd_pipelined(&ctx, pipe_fd[0], -1, 0, 0);
+    sha3_final(&ctx, output);
+    if ( (SHA3_OK != res) || memcmp(output_ref, output, sizeof(output)) ||
+         (SHA3_OK == sha3_update_fd_pipelined(&ctx, pipe_fd[0], -1, 1, 0)) ||
+         (SHA3_OK == sha3_update_fd_pipelined(&ctx, -1, -1, 0, 0)) )
+    {
+        print_test_result(3, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+    close(pipe_fd[0]);
+
+    // read error, and a tee that fails while the reader blocks in read()
+    if ( (0 != pipe(pipe_fd)) || (0 != pipe(tee_pipe)) || (write(pipe_fd[1], input, 100) != 100) )
+    {
+        print_test_result(4, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    sha3_init(SHA3_256, &ctx);
+    if ( (SHA3_OK == sha3_update_fd_pipelined(&ctx, pipe_fd[1], -1, 0, 0)) ||
+         (SHA3_OK == sha3_update_fd_pipelined(&ctx, pipe_fd[0], tee_pipe[0], 0, 0)) )
+    {
+        print_test_result(5, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    close(pipe_fd[0]);
+    close(pipe_fd[1]);
+    close(tee_pipe[0]);
+    close(tee_pipe[1]);
+
+    print_test_result(6, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_prefix_test(void)
+{
+    // Forked, peeked and cached prefix states against one-shot hashes
+    const sha3_hash_modes_t modes[] = { SHA3_224, SHA3_256, SHA3_384, SHA3_512, SHAKE128, SHAKE256 };
+    const uint32_t d[] = { SHA3_224_HASH_LEN, SHA3_256_HASH_LEN, SHA3_384_HASH_LEN, SHA3_512_HASH_LEN,
+                           SHAKE128_HASH_LEN, SHAKE256_HASH_LEN };
+    static uint8_t input[3000];
+    static sha3_prefix_cache_t cache;
+    uint8_t output[SHA3_512_HASH_LEN];
+    uint8_t output_ref[SHA3_512_HASH_LEN];
+    sha3_ctx_t ctx, fork;
+    uint32_t m, i;
+    size_t plen;
+
+    ptn_fill(input, sizeof(input));
+
+    for(m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        // prefix ends inside a block, exactly on one and past several
+        for(plen = 0; plen < 1200; plen += 197)
+        {
+            sha3_init(modes[m], &ctx);
+            sha3_update(&ctx, input, plen);
+
+            sha3_ctx_clone(&fork, &ctx);
+            sha3_update(&fork, input + plen, 700);
+
+            sha3_init(modes[m], &ctx);
+            sha3_update(&ctx, input, plen);
+            sha3_final_keep(&ctx, output_ref);
+            sha3_final_keep(&ctx, output);
+            sha3_update(&ctx, input + plen, 700);
+
+            if (memcmp(output_ref, output, d[m]))
+            {
+                print_test_result(0, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+
+            SHA3(modes[m], input, plen + 700, output_ref);
+            if ( (SHA3_OK != sha3_final(&fork, output)) ||
+                 memcmp(output_ref, output, d[m]) ||
+                 (SHA3_OK != sha3_final(&ctx, output)) ||
+                 memcmp(output_ref, output, d[m]) )
+            {
+                print_test_result(1, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+        }
+    }
+
+    // ten prefixes through eight slots twice, the last one too long to cache
+    sha3_prefix_cache_init(&cache);
+    for(i = 0; i < 20; i++)
+    {
+        plen = (i % 10 == 9) ? SHA3_PREFIX_MAX_LEN + 1 : 100 + (i % 10) * 90;
+
+        if (SHA3_OK != sha3_prefix_ctx(&cache, SHA3_256, input + (i % 10), plen, &ctx))
+        {
+            print_test_result(2, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+
+        sha3_update(&ctx, input + 2000, 33);
+        sha3_final(&ctx, output);
+
+        sha3_init(SHA3_256, &fork);
+        sha3_update(&fork, input + (i % 10), plen);
+        sha3_update(&fork, input + 2000, 33);
+        sha3_final(&fork, output_ref);
+
+        if (memcmp(output_ref, output, SHA3_256_HASH_LEN))
+        {
+            print_test_result(3, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    // one prefix over and over only misses once
+    for(i = 0; i < 5; i++)
+    {
+        sha3_prefix_ctx(&cache, SHA3_256, input, 300, &ctx);
+    }
+
+    if (cache.hits < 4)
+    {
+        print_test_result(4, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(5, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+static void sha3_mb_test_cb(sha3_mb_job_t *job)
+{
+    __atomic_fetch_add((uint32_t *)job->user_data, 1, __ATOMIC_RELAXED);
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_mb_test(void)
+{
+    // uneven lengths over all fixed-output modes, half of the jobs on
+    // callbacks and half on the completion queue
+    static const sha3_hash_modes_t modes[] = { SHA3_224, SHA3_256, SHA3_384, SHA3_512, SHAKE128, SHAKE256 };
+    static uint8_t input[5000];
+    static uint8_t output[61][SHA3_512_HASH_LEN];
+    static sha3_mb_job_t jobs[61];
+    uint8_t output_ref[SHA3_512_HASH_LEN];
+    uint32_t callbacks = 0;
+    uint32_t polled = 0;
+    uint32_t i;
+    sha3_mb_mgr_t *mgr;
+    sha3_mb_job_t *job;
+    sha3_mb_job_t bad;
+
+    ptn_fill(input, sizeof(input));
+
+    mgr = sha3_mb_create(100);
+    if (NULL == mgr)
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(i = 0; i < 61; i++)
+    {
+        memset(&jobs[i], 0, sizeof(jobs[i]));
+        jobs[i].mode = modes[i % 6];
+        jobs[i].input_data = input + i;
+        jobs[i].len = (i * i * 37) % (sizeof(input) - 61);
+        jobs[i].output_data = output[i];
+        jobs[i].callback = (i & 1) ? sha3_mb_test_cb : NULL;
+        jobs[i].user_data = &callbacks;
+        if (60 == i)
+        {
+            // an empty job without an input buffer
+            jobs[i].input_data = NULL;
+            jobs[i].len = 0;
+        }
+
+        if (SHA3_OK != sha3_mb_submit(mgr, &jobs[i]))
+        {
+            sha3_mb_destroy(mgr);
+            print_test_result(1, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    // TurboSHAKE runs 12 rounds and cannot share the lanes
+    memset(&bad, 0, sizeof(bad));
+    bad.mode = TURBOSHAKE128;
+    bad.output_data = output_ref;
+
+    sha3_mb_flush(mgr);
+
+    for(job = sha3_mb_poll(mgr); NULL != job; job = job->next)
+    {
+        polled++;
+    }
+
+    if ( (30 != callbacks) || (31 != polled) || (SHA3_OK == sha3_mb_submit(mgr, &bad)) )
+    {
+        sha3_mb_destroy(mgr);
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(i = 0; i < 61; i++)
+    {
+        if (jobs[i].mode < SHAKE128)
+        {
+            SHA3(jobs[i].mode, (NULL == jobs[i].input_data) ? input : jobs[i].input_data, jobs[i].len, output_ref);
+        }
+        else
+        {
+            SHAKE(jobs[i].mode, (NULL == jobs[i].input_data) ? input : jobs[i].input_data, jobs[i].len, output_ref,
+                  (SHAKE128 == jobs[i].mode) ? SHAKE128_HASH_LEN : SHAKE256_HASH_LEN);
+        }
+
+        if ( (SHA3_OK != jobs[i].status) ||
+             memcmp(output_ref, output[i], (SHAKE128 == jobs[i].mode) ? SHAKE128_HASH_LEN :
+                                           (SHA3_224 == jobs[i].mode) ? SHA3_224_HASH_LEN :
+                                           (SHA3_256 == jobs[i].mode) ? SHA3_256_HASH_LEN :
+                                           (SHA3_384 == jobs[i].mode) ? SHA3_384_HASH_LEN : SHA3_512_HASH_LEN) )
+        {
+            sha3_mb_destroy(mgr);
+            print_test_result(3, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    // a lone job is hashed once the timeout expires, without a flush
+    callbacks = 0;
+    jobs[1].len = 10;
+    if (SHA3_OK != sha3_mb_submit(mgr, &jobs[1]))
+    {
+        sha3_mb_destroy(mgr);
+        print_test_result(4, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(i = 0; (i < 1000) && (0 == __atomic_load_n(&callbacks, __ATOMIC_RELAXED)); i++)
+    {
+        usleep(1000);
+    }
+
+    sha3_mb_destroy(mgr);
+
+    SHA3(jobs[1].mode, input + 1, 10, output_ref);
+    if ( (1 != callbacks) || memcmp(output_ref, output[1], SHA3_224_HASH_LEN) )
+    {
+        print_test_result(5, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(6, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_merkle_test(void)
+{
+    // 7 leaves input[i .. i + 13 * i), same results as a Python model
+    // with H(00 || leaf), H(01 || left || right), odd node moved up
+    const uint8_t root_reference[SHA3_256_HASH_LEN] =
+    {
+        0x3a, 0x49, 0x1a, 0x71, 0x45, 0x4d, 0xe4, 0xf1,
+        0xed, 0x29, 0x57, 0xcb, 0x7d, 0x80, 0x06, 0x61,
+        0x5d, 0x2b, 0xdd, 0xc1, 0x72, 0xee, 0xd2, 0xb4,
+        0x8f, 0x81, 0x2e, 0x54, 0xdc, 0x75, 0xbc, 0xdd
+    };
+    static const sha3_hash_modes_t modes[] = { SHA3_256, SHA3_512 };
+    static uint8_t input[4000];
+    static const uint8_t *leaf_data[1001];
+    static size_t leaf_len[1001];
+    static uint8_t proof[SHA3_MERKLE_MAX_LEVELS * SHA3_512_HASH_LEN];
+    uint8_t root[SHA3_512_HASH_LEN];
+    uint8_t root_ref[SHA3_512_HASH_LEN];
+    sha3_merkle_t tree, tree_ref;
+    uint32_t proof_num;
+    size_t i;
+    uint32_t m;
+
+    ptn_fill(input, sizeof(input));
+
+    for(i = 0; i < 1001; i++)
+    {
+        leaf_data[i] = input + (i % 7) + ((i < 7) ? 0 : 7);
+        leaf_len[i] = (i < 7) ? 13 * i : (i * 37) % 300;
+    }
+
+    if ( (SHA3_OK != sha3_merkle_init(&tree, SHA3_256, 7)) ||
+         (SHA3_OK != sha3_merkle_build(&tree, leaf_data, leaf_len)) ||
+         (SHA3_OK != sha3_merkle_root(&tree, root)) ||
+         memcmp(root_reference, root, SHA3_256_HASH_LEN) )
+    {
+        sha3_merkle_free(&tree);
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+    sha3_merkle_free(&tree);
+
+    for(m = 0; m < 2; m++)
+    {
+        // a leaf update rehashes its path to the same root as a rebuild
+        if ( (SHA3_OK != sha3_merkle_init(&tree, modes[m], 1001)) ||
+             (SHA3_OK != sha3_merkle_init(&tree_ref, modes[m], 1001)) ||
+             (SHA3_OK != sha3_merkle_build(&tree, leaf_data, leaf_len)) )
+        {
+            print_test_result(1, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+
+        for(i = 0; i < 1001; i += 200)
+        {
+            leaf_data[i] = input + 1000;
+            leaf_len[i] = 999 - i / 200;
+            sha3_merkle_update(&tree, i, leaf_data[i], leaf_len[i]);
+        }
+
+        sha3_merkle_build(&tree_ref, leaf_data, leaf_len);
+        sha3_merkle_root(&tree, root);
+        sha3_merkle_root(&tree_ref, root_ref);
+
+        if (memcmp(root_ref, root, tree.d))
+        {
+            sha3_merkle_free(&tree);
+            sha3_merkle_free(&tree_ref);
+            print_test_result(2, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+
+        // proofs of every leaf check out, a changed leaf or proof does not
+        for(i = 0; i < 1001; i++)
+        {
+            if ( (SHA3_OK != sha3_merkle_proof(&tree, i, proof, &proof_num)) ||
+                 (SHA3_OK != sha3_merkle_verify(modes[m], root, 1001, i, leaf_data[i], leaf_len[i], proof, proof_num)) ||
+                 (SHA3_OK == sha3_merkle_verify(modes[m], root, 1001, i ^ 1, leaf_data[i], leaf_len[i], proof, proof_num)) ||
+                 (SHA3_OK == sha3_merkle_verify(modes[m], root, 1001, i, leaf_data[i], leaf_len[i] + 1, proof, proof_num)) ||
+                 (SHA3_OK == sha3_merkle_verify(modes[m], root, 1001, i, leaf_data[i], leaf_len[i], proof, proof_num - 1)) )
+            {
+                sha3_merkle_free(&tree);
+                sha3_merkle_free(&tree_ref);
+                print_test_result(3, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+        }
+
+        sha3_merkle_free(&tree);
+        sha3_merkle_free(&tree_ref);
+    }
+
+    // a single leaf is the root, with an empty proof
+    if ( (SHA3_OK != sha3_merkle_init(&tree, SHA3_256, 1)) ||
+         (SHA3_OK != sha3_merkle_build(&tree, leaf_data, leaf_len)) ||
+         (SHA3_OK != sha3_merkle_root(&tree, root)) ||
+         (SHA3_OK != sha3_merkle_proof(&tree, 0, proof, &proof_num)) || (0 != proof_num) ||
+         (SHA3_OK != sha3_merkle_verify(SHA3_256, root, 1, 0, leaf_data[0], leaf_len[0], proof, 0)) )
+    {
+        sha3_merkle_free(&tree);
+        print_test_result(4, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+    sha3_merkle_free(&tree);
+
+    print_test_result(5, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_fixed_test(void)
+{
+    // single block one-shots against the sponge for every mode
+    static const sha3_hash_modes_t modes[] = { SHA3_224, SHA3_256, SHA3_384, SHA3_512,
+                                               SHAKE128, SHAKE256, TURBOSHAKE128, TURBOSHAKE256 };
+    static const uint32_t d[] = { SHA3_224_HASH_LEN, SHA3_256_HASH_LEN, SHA3_384_HASH_LEN, SHA3_512_HASH_LEN,
+                                  SHAKE128_HASH_LEN, SHAKE256_HASH_LEN, SHAKE128_HASH_LEN, SHAKE256_HASH_LEN };
+    uint8_t input[64 + 7];
+    uint8_t output[SHA3_512_HASH_LEN];
+    uint8_t output_ref[SHA3_512_HASH_LEN];
+    uint32_t m, n;
+
+    ptn_fill(input, sizeof(input));
+
+    for(m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        for(n = 32; n <= 64; n += 32)
+        {
+            // unaligned input
+            if (m < 4)
+            {
+                SHA3(modes[m], input + m, n, output_ref);
+            }
+            else if (m < 6)
+            {
+                SHAKE(modes[m], input + m, n, output_ref, d[m]);
+            }
+            else
+            {
+                TURBOSHAKE(modes[m], 0x1F, input + m, n, output_ref, d[m]);
+            }
+
+            memset(output, 0, sizeof(output));
+            if ( (SHA3_OK != ((32 == n) ? SHA3_32(modes[m], input + m, output) : SHA3_64(modes[m], input + m, output))) ||
+                 memcmp(output_ref, output, d[m]) )
+            {
+                print_test_result(m, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+        }
+    }
+
+    if ( (SHA3_OK == SHA3_32(SHA3_256, NULL, output)) ||
+         (SHA3_OK == SHA3_64((sha3_hash_modes_t)(TURBOSHAKE256 + 1), input, output)) )
+    {
+        print_test_result(m, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(m, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+static void sha3_stats_test_hook(void *arg, const sha3_stats_event_t *event)
+{
+    uint64_t *hook = (uint64_t *)arg;
+
+    // count, last time stamp
+    hook[event->op == SHA3_STATS_ABSORB ? 0 : 1]++;
+    hook[2] = event->tsc;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_stats_test(void)
+{
+    static uint8_t input[200];
+    const uint8_t *msg[4] = { input, input + 10, input + 20, input + 30 };
+    const size_t msg_len[4] = { 10, 10, 10, 10 };
+    uint8_t output[4][SHA3_512_HASH_LEN];
+    uint8_t *out[4] = { output[0], output[1], output[2], output[3] };
+    uint64_t hook[3] = { 0, 0, 0 };
+    sha3_stats_t st;
+    sha3_ctx_t ctx;
+
+    // without SHA3_STATS there is nothing to count
+    if (SHA3_OK != sha3_stats_reset())
+    {
+        if (SHA3_OK == sha3_stats_snapshot(&st))
+        {
+            print_test_result(0, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+
+        print_test_result(5, SHA3_TEST_PASSED);
+        return SHA3_TEST_PASSED;
+    }
+
+    ptn_fill(input, sizeof(input));
+
+    // one full block and the padded tail
+    sha3_stats_set_hooks(sha3_stats_test_hook, sha3_stats_test_hook, hook);
+    SHA3(SHA3_256, input, sizeof(input), output[0]);
+    sha3_stats_set_hooks(NULL, NULL, NULL);
+    sha3_stats_snapshot(&st);
+
+    if ( (2 != st.permutations) || (200 != st.bytes_absorbed) || (32 != st.bytes_squeezed) ||
+         (1 != st.calls[SHA3_256]) || (0 != st.calls[SHA3_512]) ||
+         (2 != hook[0]) || (2 != hook[1]) || (0 == hook[2]) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    // finishing a copy is counted like sha3_final
+    sha3_stats_reset();
+    sha3_init(SHA3_256, &ctx);
+    sha3_update(&ctx, input, 10);
+    sha3_stats_set_hooks(sha3_stats_test_hook, sha3_stats_test_hook, hook);
+    sha3_final_keep(&ctx, output[0]);
+    sha3_stats_set_hooks(NULL, NULL, NULL);
+    sha3_stats_snapshot(&st);
+
+    if ( (1 != st.permutations) || (32 != st.bytes_squeezed) || (4 != hook[1]) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    sha3_stats_reset();
+    HMAC_SHA3(HMAC_SHA3_256, input, 10, input, 20, output[0]);
+    sha3_stats_snapshot(&st);
+
+    if ( (1 != st.hmac_inner) || (1 != st.hmac_outer) )
+    {
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    sha3_stats_reset();
+    SHA3_64(SHA3_512, input, output[0]);
+    sha3_hash_many(SHA3_384, msg, msg_len, out, 4);
+    sha3_stats_snapshot(&st);
+
+    if ( (1 != st.permutations) || (1 != st.calls[SHA3_512]) || (4 != st.calls[SHA3_384]) ||
+         (0 == st.lane_permutations) || (4 != st.lanes_busy) ||
+         (64 + 40 != st.bytes_absorbed) || (64 + 4 * 48 != st.bytes_squeezed) )
+    {
+        print_test_result(3, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    sha3_stats_reset();
+    sha3_stats_snapshot(&st);
+    if (0 != st.bytes_absorbed)
+    {
+        print_test_result(4, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(5, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_drbg_test(void)
+{
+    // first request: SHAKE256(bytepad(encode_string("SHA3-DRBG"), 136) ||
+    // encode_string(00 01 .. 1f) || encode_string("func_test"))
+    static const uint8_t first_ref[32] =
+    {
+        0x84, 0xcc, 0x58, 0x5a, 0x8e, 0xb8, 0xa3, 0x24, 0x9b, 0x16, 0x23, 0xbf, 0x95, 0xbe, 0x2b, 0x7b,
+        0xfd, 0x7f, 0x93, 0x47, 0x0e, 0x04, 0x3e, 0x93, 0x05, 0x9a, 0x78, 0x41, 0x0a, 0x45, 0xa3, 0x4d
+    };
+    static const uint8_t pers[] = { 'f', 'u', 'n', 'c', '_', 't', 'e', 's', 't' };
+    static uint8_t output[2][1000];
+    uint8_t entropy[SHA3_DRBG_SEED_MIN_LEN];
+    sha3_drbg_t drbg[2];
+    uint32_t i;
+
+    for(i = 0; i < sizeof(entropy); i++)
+    {
+        entropy[i] = (uint8_t)i;
+    }
+
+    // a whole request is one squeeze, blocks go straight to the buffer
+    for(i = 0; i < 2; i++)
+    {
+        if ( (SHA3_OK != sha3_drbg_seed(&drbg[i], SHAKE256, entropy, sizeof(entropy), pers, sizeof(pers))) ||
+             (SHA3_OK != sha3_drbg_generate(&drbg[i], output[i], sizeof(output[i]), NULL, 0)) ||
+             memcmp(output[i], first_ref, sizeof(first_ref)) )
+        {
+            print_test_result(0, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    // the state was re-keyed after the request, equal requests stay in step
+    sha3_drbg_generate(&drbg[0], output[0], 100, NULL, 0);
+    sha3_drbg_generate(&drbg[1], output[1], 100, NULL, 0);
+    if ( memcmp(output[0], output[1], 100) || !memcmp(output[0], first_ref, sizeof(first_ref)) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    // reseed and additional input change the stream
+    sha3_drbg_reseed(&drbg[0], pers, sizeof(pers));
+    sha3_drbg_generate(&drbg[0], output[0], 100, NULL, 0);
+    sha3_drbg_generate(&drbg[1], output[1], 100, pers, sizeof(pers));
+    if (!memcmp(output[0], output[1], 100))
+    {
+        print_test_result(2, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    sha3_drbg_wipe(&drbg[0]);
+    if ( (SHA3_OK == sha3_drbg_generate(&drbg[0], output[0], 1, NULL, 0)) ||
+         (SHA3_OK == sha3_drbg_seed(&drbg[0], TURBOSHAKE128, entropy, sizeof(entropy) - 1, NULL, 0)) ||
+         (SHA3_OK == sha3_drbg_seed(&drbg[0], SHA3_256, entropy, sizeof(entropy), NULL, 0)) )
+    {
+        print_test_result(3, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    // the thread's own generator
+    memset(output, 0, sizeof(output));
+    if ( (SHA3_OK != sha3_random(output[0], sizeof(output[0]))) ||
+         (SHA3_OK != sha3_random(output[1], sizeof(output[1]))) ||
+         !memcmp(output[0], output[1], sizeof(output[0])) ||
+         !memcmp(output[0] + 500, output[0] + 501, 32) )
+    {
+        print_test_result(4, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(5, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t sha3_aead_test(void)
+{
+    // 16 byte key 00..0f, 12 byte nonce 64..6f, AD "record header",
+    // plaintext (7 * i) & 0xff for i < 200: two plaintext blocks
+    static const uint8_t ref[2][3][32] =
+    {
+        {   // SHA3_AEAD_128: ciphertext[0..15], ciphertext[184..199], tag
+            { 0x19, 0xb7, 0xda, 0x6f, 0x66, 0x59, 0x52, 0xf6, 0x8b, 0xac, 0x63, 0x3f, 0x57, 0x8c, 0xb7, 0x56 },
+            { 0x47, 0x24, 0x7b, 0x58, 0xea, 0x5b, 0x6f, 0xc7, 0x6c, 0x76, 0x52, 0x43, 0x1f, 0x5e, 0xb5, 0x16 },
+            { 0x7c, 0xdf, 0x79, 0x80, 0x15, 0x69, 0xbb, 0xef, 0x87, 0x93, 0x13, 0xa3, 0x17, 0x37, 0xcd, 0xf0,
+              0xca, 0xa7, 0x35, 0x79, 0x8e, 0x06, 0x5b, 0xd5, 0x15, 0xf5, 0xf7, 0x5e, 0x59, 0x6d, 0x5f, 0x99 }
+        },
+        {   // SHA3_AEAD_TURBO128
+            { 0x86, 0x42, 0xe0, 0x31, 0x83, 0xaf, 0x16, 0xe5, 0x97, 0xfc, 0xdf, 0x3d, 0xd4, 0x40, 0xbb, 0xdb },
+            { 0xe1, 0x36, 0x1a, 0x3a, 0xed, 0x81, 0x0e, 0xb0, 0x76, 0x54, 0x08, 0xc1, 0x0b, 0x88, 0xe5, 0xb4 },
+            { 0x8b, 0x9f, 0x75, 0xfb, 0xd8, 0x94, 0x61, 0xa3, 0xf9, 0xc0, 0x1b, 0x91, 0xfc, 0x06, 0xb1, 0x40,
+              0xae, 0xaf, 0x02, 0xf9, 0x98, 0x66, 0x55, 0x6c, 0xb3, 0x77, 0xdf, 0xd2, 0x77, 0x84, 0x8a, 0x62 }
+        }
+    };
+    static const uint8_t ad[] = { 'r', 'e', 'c', 'o', 'r', 'd', ' ', 'h', 'e', 'a', 'd', 'e', 'r' };
+    static const size_t lens[] = { 0, 1, 8, 134, 135, 136, 166, 167, 168, 334, 335, 400 };
+    static const sha3_aead_mode_t modes[] = { SHA3_AEAD_128, SHA3_AEAD_256, SHA3_AEAD_TURBO128, SHA3_AEAD_TURBO256 };
+    static uint8_t plain[400], cipher[400], output[400];
+    uint8_t key[16], nonce[12], tag[32], ref_out[SHAKE128_HASH_LEN * 6];
+    sha3_ctx_t ctx;
+    uint32_t i, m, n;
+
+    for(i = 0; i < sizeof(plain); i++)
+    {
+        plain[i] = (uint8_t)(7 * i);
+    }
+    for(i = 0; i < sizeof(key); i++)
+    {
+        key[i] = (uint8_t)i;
+    }
+    for(i = 0; i < sizeof(nonce); i++)
+    {
+        nonce[i] = (uint8_t)(100 + i);
+    }
+
+    // a duplexing call on a fresh state is the sponge of one block
+    for(n = 0; n < 5; n++)
+    {
+        SHA3(SHA3_256, plain, lens[n], ref_out);
+        if ( (SHA3_OK != sha3_duplex_init(SHA3_256, &ctx)) ||
+             (SHA3_OK != sha3_duplex(&ctx, plain, lens[n], 0x06, output, SHA3_256_HASH_LEN)) ||
+             memcmp(ref_out, output, SHA3_256_HASH_LEN) )
+        {
+            print_test_result(0, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    SHAKE(SHAKE128, plain, 167, ref_out, 168);
+    if ( (SHA3_OK != sha3_duplex_init(SHAKE128, &ctx)) ||
+         (SHA3_OK != sha3_duplex(&ctx, plain, 167, 0x1F, output, 168)) || memcmp(ref_out, output, 168) ||
+         (SHA3_OK == sha3_duplex(&ctx, plain, 168, 0x1F, NULL, 0)) ||
+         (SHA3_OK == sha3_update(&ctx, plain, 1)) )
+    {
+        print_test_result(1, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(m = 0; m < 2; m++)
+    {
+        if ( (SHA3_AEAD_OK != SHA3_AEAD_ENCRYPT(modes[2 * m], key, sizeof(key), nonce, sizeof(nonce),
+                                                ad, sizeof(ad), plain, 200, cipher, tag, sizeof(tag))) ||
+             memcmp(cipher, ref[m][0], 16) || memcmp(cipher + 184, ref[m][1], 16) ||
+             memcmp(tag, ref[m][2], sizeof(tag)) )
+        {
+            print_test_result(2, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    // block boundaries of plaintext and AD, in place, forgeries
+    for(m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        for(n = 0; n < sizeof(lens) / sizeof(lens[0]); n++)
+        {
+            memcpy(cipher, plain, lens[n]);
+            if ( (SHA3_AEAD_OK != SHA3_AEAD_ENCRYPT(modes[m], key, sizeof(key), nonce, sizeof(nonce),
+                                                    plain, lens[n % 9], cipher, lens[n], cipher, tag, sizeof(tag))) ||
+                 (SHA3_AEAD_OK != SHA3_AEAD_DECRYPT(modes[m], key, sizeof(key), nonce, sizeof(nonce),
+                                                    plain, lens[n % 9], cipher, lens[n], tag, sizeof(tag), output)) ||
+                 memcmp(output, plain, lens[n]) )
+            {
+                print_test_result(3, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+
+            tag[n % sizeof(tag)] ^= 0x01;
+            if ( (SHA3_AEAD_TAG_MISMATCH != SHA3_AEAD_DECRYPT(modes[m], key, sizeof(key), nonce, sizeof(nonce),
+                                                               plain, lens[n % 9], cipher, lens[n], tag, sizeof(tag), output)) ||
+                 ( (lens[n] != 0) && (0 != output[0] || 0 != output[lens[n] - 1]) ) )
+            {
+                print_test_result(4, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+            tag[n % sizeof(tag)] ^= 0x01;
+
+            if (lens[n] != 0)
+            {
+                cipher[lens[n] - 1] ^= 0x80;
+                if (SHA3_AEAD_TAG_MISMATCH != SHA3_AEAD_DECRYPT(modes[m], key, sizeof(key), nonce, sizeof(nonce),
+                                                                 plain, lens[n % 9], cipher, lens[n], tag, sizeof(tag), output))
+                {
+                    print_test_result(5, SHA3_TEST_FAILS);
+                    return SHA3_TEST_FAILS;
+                }
+            }
+
+            if (SHA3_AEAD_TAG_MISMATCH != SHA3_AEAD_DECRYPT(modes[m], key, sizeof(key), nonce, sizeof(nonce) - 1,
+                                                             plain, lens[n % 9], cipher, lens[n], tag, sizeof(tag), output))
+            {
+                print_test_result(6, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+        }
+    }
+
+    if ( (SHA3_AEAD_ERROR != SHA3_AEAD_ENCRYPT(SHA3_AEAD_128, key, SHA3_AEAD_MIN_KEY_LEN - 1, NULL, 0,
+                                               NULL, 0, plain, 1, cipher, tag, sizeof(tag))) ||
+         (SHA3_AEAD_ERROR != SHA3_AEAD_ENCRYPT(SHA3_AEAD_128, key, sizeof(key), NULL, 0,
+                                               NULL, 0, plain, 1, cipher, tag, SHA3_AEAD_MIN_TAG_LEN - 1)) )
+    {
+        print_test_result(7, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(8, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
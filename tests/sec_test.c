@@ -0,0 +1,41 @@
+/*
+ ============================================================================
+ Name        : sec_test.c
+ Author      : Sergii Sidorov
+ Version     : 1.0.0
+ Copyright   : Your copyright notice
+ Description : SHA3 security tests
+ ============================================================================
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hmac_sha3.h"
+#include "tests.h"
+
+//---------------------------------------------------------------------
+sha3_test_result_t hmac_sha3_key_test(void)
+{
+    // Keys longer than the block are hashed into a local buffer, not in place
+    uint8_t key[300];
+    uint8_t key_copy[sizeof(key)];
+    uint8_t output[SHA3_512_HMAC_LEN];
+    uint32_t i;
+
+    for(i = 0; i < sizeof(key); i++)
+    {
+        key[i] = (uint8_t)(i * 7 + 3);
+    }
+    memcpy(key_copy, key, sizeof(key));
+
+    if ( (HMAC_SHA3_OK != HMAC_SHA3(HMAC_SHA3_512, key, 10, key, sizeof(key), output)) ||
+         memcmp(key_copy, key, sizeof(key)) )
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    print_test_result(1, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
@@ -12,13 +12,8 @@
 #include <string.h>
 
 #include "sha3.h"
-
-typedef enum
-{
-    SHA3_TEST_PASSED = 0,
-    SHA3_TEST_FAILS,
-    SHA3_TEST_NOT_IMPLEMENTED
-}sha3_test_result_t;
+#include "keccak.h"
+#include "tests.h"
 
 //---------------------------------------------------------------------
 static void print_test_info(uint32_t test_num, sha3_test_result_t res)
@@ -28,7 +23,7 @@ static void print_test_info(uint32_t test_num, sha3_test_result_t res)
 }
 
 //---------------------------------------------------------------------
-static void print_test_result(uint32_t test_num, sha3_test_result_t res)
+void print_test_result(uint32_t test_num, sha3_test_result_t res)
 {
     printf("\n ************************************************* \n");
     if (SHA3_TEST_PASSED == res)
@@ -58,11 +53,40 @@ static sha3_test_result_t sha3_null_string_test(sha3_hash_modes_t sha3_mode, uin
 
     uint8_t output_str[SHA3_512_HASH_LEN] = {0};
 
-    //TODO add test vectors
-    const uint8_t output_reference_res_sha3_224[SHA3_224_HASH_LEN] = {0};
-    const uint8_t output_reference_res_sha3_256[SHA3_256_HASH_LEN] = {0};
-    const uint8_t output_reference_res_sha3_384[SHA3_384_HASH_LEN] = {0};
-    const uint8_t output_reference_res_sha3_512[SHA3_512_HASH_LEN] = {0};
+    const uint8_t output_reference_res_sha3_224[SHA3_224_HASH_LEN] =
+    {
+        0x6b, 0x4e, 0x03, 0x42, 0x36, 0x67, 0xdb, 0xb7,
+        0x3b, 0x6e, 0x15, 0x45, 0x4f, 0x0e, 0xb1, 0xab,
+        0xd4, 0x59, 0x7f, 0x9a, 0x1b, 0x07, 0x8e, 0x3f,
+        0x5b, 0x5a, 0x6b, 0xc7
+    };
+    const uint8_t output_reference_res_sha3_256[SHA3_256_HASH_LEN] =
+    {
+        0xa7, 0xff, 0xc6, 0xf8, 0xbf, 0x1e, 0xd7, 0x66,
+        0x51, 0xc1, 0x47, 0x56, 0xa0, 0x61, 0xd6, 0x62,
+        0xf5, 0x80, 0xff, 0x4d, 0xe4, 0x3b, 0x49, 0xfa,
+        0x82, 0xd8, 0x0a, 0x4b, 0x80, 0xf8, 0x43, 0x4a
+    };
+    const uint8_t output_reference_res_sha3_384[SHA3_384_HASH_LEN] =
+    {
+        0x0c, 0x63, 0xa7, 0x5b, 0x84, 0x5e, 0x4f, 0x7d,
+        0x01, 0x10, 0x7d, 0x85, 0x2e, 0x4c, 0x24, 0x85,
+        0xc5, 0x1a, 0x50, 0xaa, 0xaa, 0x94, 0xfc, 0x61,
+        0x99, 0x5e, 0x71, 0xbb, 0xee, 0x98, 0x3a, 0x2a,
+        0xc3, 0x71, 0x38, 0x31, 0x26, 0x4a, 0xdb, 0x47,
+        0xfb, 0x6b, 0xd1, 0xe0, 0x58, 0xd5, 0xf0, 0x04
+    };
+    const uint8_t output_reference_res_sha3_512[SHA3_512_HASH_LEN] =
+    {
+        0xa6, 0x9f, 0x73, 0xcc, 0xa2, 0x3a, 0x9a, 0xc5,
+        0xc8, 0xb5, 0x67, 0xdc, 0x18, 0x5a, 0x75, 0x6e,
+        0x97, 0xc9, 0x82, 0x16, 0x4f, 0xe2, 0x58, 0x59,
+        0xe0, 0xd1, 0xdc, 0xc1, 0x47, 0x5c, 0x80, 0xa6,
+        0x15, 0xb2, 0x12, 0x3a, 0xf1, 0xf5, 0xf9, 0x4c,
+        0x11, 0xe3, 0xe9, 0x40, 0x2c, 0x3a, 0xc5, 0x58,
+        0xf5, 0x00, 0x19, 0x9d, 0x95, 0xb6, 0xd3, 0xe3,
+        0x01, 0x75, 0x85, 0x86, 0x28, 0x1d, 0xcd, 0x26
+    };
 
     sha3_status_t res  = SHA3_ERROR;
 
@@ -145,11 +169,40 @@ static sha3_test_result_t sha3_ancronim_string_test(sha3_hash_modes_t sha3_mode,
 
     uint8_t output_str[SHA3_512_HASH_LEN] = {0};
 
-    //TODO add test vectors
-    const uint8_t output_reference_res_sha3_224[SHA3_224_HASH_LEN] = {0};
-    const uint8_t output_reference_res_sha3_256[SHA3_256_HASH_LEN] = {0};
-    const uint8_t output_reference_res_sha3_384[SHA3_384_HASH_LEN] = {0};
-    const uint8_t output_reference_res_sha3_512[SHA3_512_HASH_LEN] = {0};
+    const uint8_t output_reference_res_sha3_224[SHA3_224_HASH_LEN] =
+    {
+        0xd1, 0x5d, 0xad, 0xce, 0xaa, 0x4d, 0x5d, 0x7b,
+        0xb3, 0xb4, 0x8f, 0x44, 0x64, 0x21, 0xd5, 0x42,
+        0xe0, 0x8a, 0xd8, 0x88, 0x73, 0x05, 0xe2, 0x8d,
+        0x58, 0x33, 0x57, 0x95
+    };
+    const uint8_t output_reference_res_sha3_256[SHA3_256_HASH_LEN] =
+    {
+        0x69, 0x07, 0x0d, 0xda, 0x01, 0x97, 0x5c, 0x8c,
+        0x12, 0x0c, 0x3a, 0xad, 0xa1, 0xb2, 0x82, 0x39,
+        0x4e, 0x7f, 0x03, 0x2f, 0xa9, 0xcf, 0x32, 0xf4,
+        0xcb, 0x22, 0x59, 0xa0, 0x89, 0x7d, 0xfc, 0x04
+    };
+    const uint8_t output_reference_res_sha3_384[SHA3_384_HASH_LEN] =
+    {
+        0x70, 0x63, 0x46, 0x5e, 0x08, 0xa9, 0x3b, 0xce,
+        0x31, 0xcd, 0x89, 0xd2, 0xe3, 0xca, 0x8f, 0x60,
+        0x24, 0x98, 0x69, 0x6e, 0x25, 0x35, 0x92, 0xed,
+        0x26, 0xf0, 0x7b, 0xf7, 0xe7, 0x03, 0xcf, 0x32,
+        0x85, 0x81, 0xe1, 0x47, 0x1a, 0x7b, 0xa7, 0xab,
+        0x11, 0x9b, 0x1a, 0x9e, 0xbd, 0xf8, 0xbe, 0x41
+    };
+    const uint8_t output_reference_res_sha3_512[SHA3_512_HASH_LEN] =
+    {
+        0x01, 0xde, 0xdd, 0x5d, 0xe4, 0xef, 0x14, 0x64,
+        0x24, 0x45, 0xba, 0x5f, 0x5b, 0x97, 0xc1, 0x5e,
+        0x47, 0xb9, 0xad, 0x93, 0x13, 0x26, 0xe4, 0xb0,
+        0x72, 0x7c, 0xd9, 0x4c, 0xef, 0xc4, 0x4f, 0xff,
+        0x23, 0xf0, 0x7b, 0xf5, 0x43, 0x13, 0x99, 0x39,
+        0xb4, 0x91, 0x28, 0xca, 0xf4, 0x36, 0xdc, 0x1b,
+        0xde, 0xe5, 0x4f, 0xcb, 0x24, 0x02, 0x3a, 0x08,
+        0xd9, 0x40, 0x3f, 0x9b, 0x4b, 0xf0, 0xd4, 0x50
+    };
 
     sha3_status_t res  = SHA3_ERROR;
 
@@ -226,15 +279,109 @@ static sha3_test_result_t sha3_ancronim_string_test(sha3_hash_modes_t sha3_mode,
 //---------------------------------------------------------------------
 static sha3_test_result_t sha3_sream_test(sha3_hash_modes_t sha3_mode)
 {
-    //TODO
-    return SHA3_TEST_NOT_IMPLEMENTED;
+    // Feed the same message in chunks of every size around the rate
+    // and check the stream against the single call result.
+    static uint8_t input[1024];
+    uint8_t output_ref[SHA3_512_HASH_LEN] = {0};
+    uint8_t output_str[SHA3_512_HASH_LEN] = {0};
+    sha3_ctx_t ctx;
+    uint32_t chunk, pos, n;
+    int i;
+
+    for(i = 0; i < sizeof(input); i++)
+    {
+        input[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    if (SHA3_OK != SHA3(sha3_mode, input, sizeof(input), output_ref))
+    {
+        print_test_result(0, SHA3_TEST_FAILS);
+        return SHA3_TEST_FAILS;
+    }
+
+    for(chunk = 1; chunk <= 300; chunk++)
+    {
+        sha3_init(sha3_mode, &ctx);
+
+        for(pos = 0; pos < sizeof(input); pos += n)
+        {
+            n = sizeof(input) - pos;
+            if (n > chunk)
+            {
+                n = chunk;
+            }
+            sha3_update(&ctx, input + pos, n);
+        }
+
+        sha3_final(&ctx, output_str);
+
+        if (memcmp(output_ref, output_str, ctx.d))
+        {
+            print_test_result(chunk, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    print_test_result(chunk, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
 }
 
 //---------------------------------------------------------------------
 int main(void)
 {
-    sha3_null_string_test(SHA3_256, 1);
-    sha3_ancronim_string_test(SHA3_256, 1);
-	
-    return 0;
+    const sha3_hash_modes_t modes[] = { SHA3_224, SHA3_256, SHA3_384, SHA3_512 };
+    const hmac_sha3_hash_mode_t hmac_modes[] = { HMAC_SHA3_224, HMAC_SHA3_256, HMAC_SHA3_384, HMAC_SHA3_512 };
+    const char *impls[] = { "generic", "avx2", "avx512" };
+    int fails = 0;
+    int i, j;
+
+    for(i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        fails += (SHA3_TEST_PASSED != sha3_null_string_test(modes[i], 1));
+        fails += (SHA3_TEST_PASSED != sha3_ancronim_string_test(modes[i], 1));
+        fails += (SHA3_TEST_PASSED != sha3_sream_test(modes[i]));
+    }
+
+    // batch hashing on every multi-lane backend the CPU supports
+    for(j = 0; j < sizeof(impls) / sizeof(impls[0]); j++)
+    {
+        if (NULL == keccak_select_impl(impls[j]))
+        {
+            continue;
+        }
+
+        for(i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+        {
+            fails += (SHA3_TEST_PASSED != sha3_hash_many_test(modes[i]));
+            fails += (SHA3_TEST_PASSED != hmac_sha3_verify_many_test(hmac_modes[i]));
+        }
+
+        fails += (SHA3_TEST_PASSED != sha3_mb_test());
+    }
+    keccak_select_impl(NULL);
+
+    fails += (SHA3_TEST_PASSED != sha3_shake_test());
+    fails += (SHA3_TEST_PASSED != sha3_fixed_test());
+    fails += (SHA3_TEST_PASSED != kmac_sha3_test());
+    fails += (SHA3_TEST_PASSED != parallelhash_test());
+    fails += (SHA3_TEST_PASSED != kangarootwelve_test());
+    fails += (SHA3_TEST_PASSED != sha3_pool_fork_test());
+    fails += (SHA3_TEST_PASSED != hmac_sha3_test());
+    fails += (SHA3_TEST_PASSED != sha3_file_test());
+    fails += (SHA3_TEST_PASSED != sha3_pipe_test());
+    fails += (SHA3_TEST_PASSED != sha3_prefix_test());
+    fails += (SHA3_TEST_PASSED != sha3_merkle_test());
+    fails += (SHA3_TEST_PASSED != sha3_stats_test());
+    fails += (SHA3_TEST_PASSED != sha3_drbg_test());
+    fails += (SHA3_TEST_PASSED != sha3_aead_test());
+    fails += (SHA3_TEST_PASSED != sha3_hpp_test());
+    fails += (SHA3_TEST_PASSED != sha3_constexpr_test());
+    fails += (SHA3_TEST_PASSED != hmac_sha3_key_test());
+
+    fails += (SHA3_TEST_PASSED != keccak_unrolled_test(1000));
+    fails += (SHA3_TEST_PASSED != keccak_interleaved_test(1000));
+    fails += (SHA3_TEST_PASSED != keccak_x4_test(1000));
+    fails += (SHA3_TEST_PASSED != keccak_x8_test(1000));
+
+    return fails ? 1 : 0;
 }
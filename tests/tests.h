@@ -0,0 +1,67 @@
+/*
+ ============================================================================
+ Name        : tests.h
+ Author      : Sergii Sidorov
+ Version     : 1.0.0
+ Copyright   : Your copyright notice
+ Description : Shared definitions of SHA3 test suites
+ ============================================================================
+ */
+#ifndef __SHA3_TESTS_H_
+#define __SHA3_TESTS_H_
+
+#include <stdint.h>
+
+#include "sha3.h"
+#include "hmac_sha3.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    SHA3_TEST_PASSED = 0,
+    SHA3_TEST_FAILS,
+    SHA3_TEST_NOT_IMPLEMENTED
+}sha3_test_result_t;
+
+void print_test_result(uint32_t test_num, sha3_test_result_t res);
+
+// unit_test.c
+sha3_test_result_t keccak_unrolled_test(uint32_t repeat_num);
+sha3_test_result_t keccak_interleaved_test(uint32_t repeat_num);
+sha3_test_result_t keccak_x4_test(uint32_t repeat_num);
+sha3_test_result_t keccak_x8_test(uint32_t repeat_num);
+
+// func_test.c
+sha3_test_result_t sha3_hash_many_test(sha3_hash_modes_t sha3_mode);
+sha3_test_result_t sha3_shake_test(void);
+sha3_test_result_t kmac_sha3_test(void);
+sha3_test_result_t parallelhash_test(void);
+sha3_test_result_t kangarootwelve_test(void);
+sha3_test_result_t sha3_pool_fork_test(void);
+sha3_test_result_t hmac_sha3_test(void);
+sha3_test_result_t hmac_sha3_verify_many_test(hmac_sha3_hash_mode_t hmac_mode);
+sha3_test_result_t sha3_file_test(void);
+sha3_test_result_t sha3_pipe_test(void);
+sha3_test_result_t sha3_prefix_test(void);
+sha3_test_result_t sha3_mb_test(void);
+sha3_test_result_t sha3_merkle_test(void);
+sha3_test_result_t sha3_fixed_test(void);
+sha3_test_result_t sha3_stats_test(void);
+sha3_test_result_t sha3_drbg_test(void);
+sha3_test_result_t sha3_aead_test(void);
+
+// sec_test.c
+sha3_test_result_t hmac_sha3_key_test(void);
+
+// cpp_test.cpp
+sha3_test_result_t sha3_hpp_test(void);
+sha3_test_result_t sha3_constexpr_test(void);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif // __SHA3_TESTS_H_
@@ -0,0 +1,202 @@
+/*
+ ============================================================================
+ Name        : unit_test.c
+ Author      : Sergii Sidorov
+ Version     : 1.0.0
+ Copyright   : Your copyright notice
+ Description : Keccak permutation unit tests
+ ============================================================================
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "keccak.h"
+#include "tests.h"
+
+//---------------------------------------------------------------------
+static uint64_t test_rand64(uint64_t *seed)
+{
+    // xorshift64*, deterministic states for reproducible failures
+    *seed ^= *seed >> 12;
+    *seed ^= *seed << 25;
+    *seed ^= *seed >> 27;
+    return *seed * 0x2545F4914F6CDD1DULL;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t keccak_unrolled_test(uint32_t repeat_num)
+{
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    uint64_t s_ref[25];
+    uint64_t s_unr[25];
+    uint32_t i;
+    int j;
+
+    for(i = 0; i < repeat_num; i++)
+    {
+        for(j = 0; j < 25; j++)
+        {
+            s_ref[j] = s_unr[j] = test_rand64(&seed);
+        }
+
+        keccak_fn(s_ref, KECCAK_ROUNDS);
+        keccak_fn_unrolled(s_unr, KECCAK_ROUNDS);
+
+        if (memcmp(s_ref, s_unr, sizeof(s_ref)))
+        {
+            print_test_result(i, SHA3_TEST_FAILS);
+            return SHA3_TEST_FAILS;
+        }
+    }
+
+    print_test_result(i, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t keccak_interleaved_test(uint32_t repeat_num)
+{
+    uint64_t seed = 0x94D049BB133111EBULL;
+    uint64_t s_ref[25];
+    uint64_t s_il[25];
+    uint32_t i;
+    int j;
+
+    for(i = 0; i < repeat_num; i++)
+    {
+        for(j = 0; j < 25; j++)
+        {
+            s_ref[j] = test_rand64(&seed);
+            s_il[j] = keccak_interleave(s_ref[j]);
+        }
+
+        // 12 rounds too, TurboSHAKE runs the last half
+        keccak_fn(s_ref, (i & 1) ? 12 : KECCAK_ROUNDS);
+        keccak_fn_interleaved(s_il, (i & 1) ? 12 : KECCAK_ROUNDS);
+
+        for(j = 0; j < 25; j++)
+        {
+            if ( (keccak_deinterleave(s_il[j]) != s_ref[j]) ||
+                 (keccak_interleave(s_ref[j]) != s_il[j]) )
+            {
+                print_test_result(i, SHA3_TEST_FAILS);
+                return SHA3_TEST_FAILS;
+            }
+        }
+    }
+
+    print_test_result(i, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t keccak_x4_test(uint32_t repeat_num)
+{
+    uint64_t seed = 0xD1B54A32D192ED03ULL;
+    uint64_t s_ref[4][25];
+    uint64_t s_x4[25 * 4];
+    uint64_t s_avx2[25 * 4];
+    uint32_t i;
+    int j, k;
+
+    for(i = 0; i < repeat_num; i++)
+    {
+        for(j = 0; j < 25; j++)
+        {
+            for(k = 0; k < 4; k++)
+            {
+                s_ref[k][j] = s_x4[4 * j + k] = s_avx2[4 * j + k] = test_rand64(&seed);
+            }
+        }
+
+        for(k = 0; k < 4; k++)
+        {
+            keccak_fn(s_ref[k], KECCAK_ROUNDS);
+        }
+
+        keccak_fn_x4(s_x4, KECCAK_ROUNDS);
+#ifdef KECCAK_HAVE_AVX2
+        if (__builtin_cpu_supports("avx2"))
+        {
+            keccak_fn_x4_avx2(s_avx2, KECCAK_ROUNDS);
+        }
+        else
+        {
+            keccak_fn_x4(s_avx2, KECCAK_ROUNDS);
+        }
+#else
+        keccak_fn_x4(s_avx2, KECCAK_ROUNDS);
+#endif
+
+        for(j = 0; j < 25; j++)
+        {
+            for(k = 0; k < 4; k++)
+            {
+                if ( (s_ref[k][j] != s_x4[4 * j + k]) || (s_ref[k][j] != s_avx2[4 * j + k]) )
+                {
+                    print_test_result(i, SHA3_TEST_FAILS);
+                    return SHA3_TEST_FAILS;
+                }
+            }
+        }
+    }
+
+    print_test_result(i, SHA3_TEST_PASSED);
+    return SHA3_TEST_PASSED;
+}
+
+//---------------------------------------------------------------------
+sha3_test_result_t keccak_x8_test(uint32_t repeat_num)
+{
+#ifdef KECCAK_HAVE_AVX512
+    uint64_t seed = 0x94D049BB133111EBULL;
+    uint64_t s_ref[8][25];
+    uint64_t s_x8[25 * 8];
+    uint32_t i;
+    int j, k;
+
+    if (NULL == keccak_select_impl("avx512"))
+    {
+        keccak_select_impl(NULL);
+        print_test_result(0, SHA3_TEST_NOT_IMPLEMENTED);
+        return SHA3_TEST_PASSED;
+    }
+    keccak_select_impl(NULL);
+
+    for(i = 0; i < repeat_num; i++)
+    {
+        for(j = 0; j < 25; j++)
+        {
+            for(k = 0; k < 8; k++)
+            {
+                s_ref[k][j] = s_x8[8 * j + k] = test_rand64(&seed);
+            }
+        }
+
+        for(k = 0; k < 8; k++)
+        {
+            keccak_fn(s_ref[k], KECCAK_ROUNDS);
+        }
+
+        keccak_fn_x8_avx512(s_x8, KECCAK_ROUNDS);
+
+        for(j = 0; j < 25; j++)
+        {
+            for(k = 0; k < 8; k++)
+            {
+                if (s_ref[k][j] != s_x8[8 * j + k])
+                {
+                    print_test_result(i, SHA3_TEST_FAILS);
+                    return SHA3_TEST_FAILS;
+                }
+            }
+        }
+    }
+
+    print_test_result(i, SHA3_TEST_PASSED);
+#else
+    print_test_result(0, SHA3_TEST_NOT_IMPLEMENTED);
+#endif
+    return SHA3_TEST_PASSED;
+}
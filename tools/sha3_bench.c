@@ -0,0 +1,889 @@
+/**
+* @file  sha3_bench.c
+* @brief Throughput benchmark of the SHA3 modes with JSON output
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC
+#endif
+
+#include "sha3.h"
+#include "keccak.h"
+#include "hmac_sha3.h"
+#include "kmac_sha3.h"
+#include "sha3_mb.h"
+#include "sha3_drbg.h"
+#include "sha3_aead.h"
+
+#define BENCH_MAX_SAMPLES   101
+#define BENCH_DEF_SAMPLES   11
+#define BENCH_MIN_SAMPLES   3                  // for calls longer than BENCH_LONG_NS
+#define BENCH_LONG_NS       50000000.0
+#define BENCH_SAMPLE_NS     2000000.0          // iterations per sample are scaled to this
+#define BENCH_DEF_MAX_LEN   ((size_t)1 << 30)
+#define BENCH_BATCH         KECCAK_MAX_LANES
+#define BENCH_MB_JOBS       16
+#define BENCH_DEF_CALLS     2000               // latency mode: timed calls per size
+#define BENCH_DEF_BLOCKS    3                  // latency mode: sizes up to this many rate blocks
+#define BENCH_LAT_WARMUP    64
+#define BENCH_MAX_BLOCKS    64
+#define BENCH_MAX_CALLS     10000000
+
+typedef void (*bench_fn_t)(const uint8_t *in, size_t len);
+
+typedef struct bench_mode
+{
+    const char *name;
+    bench_fn_t  fn;
+} bench_mode_t;
+
+typedef struct bench_stat
+{
+    double median;
+    double min;
+    double max;
+} bench_stat_t;
+
+typedef struct bench_opts
+{
+    size_t      max_len;
+    uint32_t    samples;
+    int         cpu;
+    const char *filter;
+    uint32_t    blocks;                        // latency mode when not 0
+    uint32_t    calls;
+} bench_opts_t;
+
+typedef struct bench_latency_mode
+{
+    const char        *name;
+    sha3_hash_modes_t  mode;
+} bench_latency_mode_t;
+
+static uint8_t bench_out[SHA3_MAX_RATE_LEN * 2];
+static const uint8_t bench_key[32] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+static hmac_sha3_ctx_t bench_hmac_ctx;
+static double bench_tsc_ghz;
+
+// Timers
+//-------------------------------------------------------
+static inline uint64_t bench_ticks(void)
+{
+#ifdef BENCH_HAVE_TSC
+    uint64_t t;
+
+    _mm_lfence();
+    t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    return 0;
+#endif
+}
+
+//-------------------------------------------------------
+static inline double bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// TSC ticks per ns, 0 without a TSC
+//-------------------------------------------------------
+static double bench_calibrate_tsc(void)
+{
+    double t0, t1;
+    uint64_t c0, c1;
+
+    t0 = bench_now_ns();
+    c0 = bench_ticks();
+    do
+    {
+        t1 = bench_now_ns();
+    } while (t1 - t0 < 50e6);
+    c1 = bench_ticks();
+
+    return (double)(c1 - c0) / (t1 - t0);
+}
+
+// Modes, every call hashes len bytes
+//-------------------------------------------------------
+static void bench_sha3_224(const uint8_t *in, size_t len) { SHA3(SHA3_224, in, len, bench_out); }
+static void bench_sha3_256(const uint8_t *in, size_t len) { SHA3(SHA3_256, in, len, bench_out); }
+static void bench_sha3_384(const uint8_t *in, size_t len) { SHA3(SHA3_384, in, len, bench_out); }
+static void bench_sha3_512(const uint8_t *in, size_t len) { SHA3(SHA3_512, in, len, bench_out); }
+static void bench_shake128(const uint8_t *in, size_t len) { SHAKE(SHAKE128, in, len, bench_out, 32); }
+static void bench_shake256(const uint8_t *in, size_t len) { SHAKE(SHAKE256, in, len, bench_out, 64); }
+
+static void bench_turboshake128(const uint8_t *in, size_t len)
+{
+    TURBOSHAKE(TURBOSHAKE128, 0x1F, in, len, bench_out, 32);
+}
+
+static void bench_kt128(const uint8_t *in, size_t len)
+{
+    KANGAROOTWELVE(TURBOSHAKE128, in, len, NULL, 0, bench_out, 32);
+}
+
+static void bench_parallelhash128(const uint8_t *in, size_t len)
+{
+    PARALLELHASH(SHAKE128, in, len, 8192, NULL, 0, bench_out, 32);
+}
+
+static void bench_kmac128(const uint8_t *in, size_t len)
+{
+    KMAC_SHA3(KMAC_SHA3_128, in, len, bench_key, sizeof(bench_key), NULL, 0, bench_out, 32);
+}
+
+// One-shot, key setup included
+static void bench_hmac_sha3_256(const uint8_t *in, size_t len)
+{
+    HMAC_SHA3(HMAC_SHA3_256, in, len, bench_key, sizeof(bench_key), bench_out);
+}
+
+// Precomputed key, per message cost only
+static void bench_hmac_sha3_256_reset(const uint8_t *in, size_t len)
+{
+    hmac_sha3_reset(&bench_hmac_ctx);
+    hmac_sha3_update(&bench_hmac_ctx, in, len);
+    hmac_sha3_final(&bench_hmac_ctx, bench_out);
+}
+
+// Squeezes len bytes, input is empty
+static void bench_shake128_squeeze(const uint8_t *in, size_t len)
+{
+    static uint8_t *out = NULL;
+    static size_t out_len = 0;
+    sha3_ctx_t ctx;
+
+    if (out_len < len)
+    {
+        free(out);
+        out = (uint8_t *)malloc(len);
+        out_len = (NULL == out) ? 0 : len;
+    }
+
+    sha3_init(SHAKE128, &ctx);
+    sha3_squeeze(&ctx, (NULL == out) ? bench_out : out, (NULL == out) ? 0 : len);
+}
+
+// len random bytes from the thread's DRBG
+static void bench_random(const uint8_t *in, size_t len)
+{
+    static uint8_t *out = NULL;
+    static size_t out_len = 0;
+
+    (void)in;
+    if (out_len < len)
+    {
+        free(out);
+        out = (uint8_t *)malloc(len);
+        out_len = (NULL == out) ? 0 : len;
+    }
+
+    sha3_random((NULL == out) ? bench_out : out, (NULL == out) ? 0 : len);
+}
+
+// Encrypts len bytes with a 16 byte nonce and tag
+static void bench_aead(sha3_aead_mode_t mode, const uint8_t *in, size_t len)
+{
+    static uint8_t *out = NULL;
+    static size_t out_len = 0;
+
+    if (out_len < len)
+    {
+        free(out);
+        out = (uint8_t *)malloc(len);
+        out_len = (NULL == out) ? 0 : len;
+    }
+
+    SHA3_AEAD_ENCRYPT(mode, bench_key, sizeof(bench_key), bench_key, 16, NULL, 0,
+                      in, (NULL == out) ? 0 : len, out, bench_out, 16);
+}
+
+static void bench_aead128(const uint8_t *in, size_t len) { bench_aead(SHA3_AEAD_128, in, len); }
+static void bench_aead_turbo128(const uint8_t *in, size_t len) { bench_aead(SHA3_AEAD_TURBO128, in, len); }
+
+// len bytes split into BENCH_BATCH messages hashed by the multi-lane kernel
+static void bench_sha3_256_many(const uint8_t *in, size_t len)
+{
+    const uint8_t *msg[BENCH_BATCH];
+    uint8_t *out[BENCH_BATCH];
+    size_t msg_len[BENCH_BATCH];
+    uint32_t i;
+
+    for(i = 0; i < BENCH_BATCH; i++)
+    {
+        msg_len[i] = len / BENCH_BATCH + ((i < len % BENCH_BATCH) ? 1 : 0);
+        msg[i] = in;
+        in += msg_len[i];
+        out[i] = bench_out + (i % 2) * SHA3_256_HASH_LEN;
+    }
+
+    sha3_hash_many(SHA3_256, msg, msg_len, out, BENCH_BATCH);
+}
+
+// len bytes split into BENCH_MB_JOBS messages of growing length (1:2:..:16)
+// hashed by the job manager
+static void bench_sha3_256_mb(const uint8_t *in, size_t len)
+{
+    static sha3_mb_mgr_t *mgr;
+    static sha3_mb_job_t jobs[BENCH_MB_JOBS];
+    const size_t parts = BENCH_MB_JOBS * (BENCH_MB_JOBS + 1) / 2;
+    size_t off = 0;
+    uint32_t i;
+
+    if (NULL == mgr)
+    {
+        mgr = sha3_mb_create(0);
+    }
+
+    for(i = 0; i < BENCH_MB_JOBS; i++)
+    {
+        jobs[i].mode = SHA3_256;
+        jobs[i].input_data = in + off;
+        jobs[i].len = (i + 1 == BENCH_MB_JOBS) ? len - off : len / parts * (i + 1);
+        jobs[i].output_data = bench_out + (i % 2) * SHA3_256_HASH_LEN;
+        jobs[i].callback = NULL;
+        off += jobs[i].len;
+        sha3_mb_submit(mgr, &jobs[i]);
+    }
+
+    sha3_mb_flush(mgr);
+    sha3_mb_poll(mgr);
+}
+
+static const bench_mode_t bench_modes[] =
+{
+    { "sha3-224",            bench_sha3_224 },
+    { "sha3-256",            bench_sha3_256 },
+    { "sha3-384",            bench_sha3_384 },
+    { "sha3-512",            bench_sha3_512 },
+    { "shake128",            bench_shake128 },
+    { "shake256",            bench_shake256 },
+    { "shake128-squeeze",    bench_shake128_squeeze },
+    { "turboshake128",       bench_turboshake128 },
+    { "kt128",               bench_kt128 },
+    { "parallelhash128",     bench_parallelhash128 },
+    { "kmac128",             bench_kmac128 },
+    { "hmac-sha3-256",       bench_hmac_sha3_256 },
+    { "hmac-sha3-256-reset", bench_hmac_sha3_256_reset },
+    { "sha3-256-many",       bench_sha3_256_many },
+    { "sha3-256-mb",         bench_sha3_256_mb },
+    { "random",              bench_random },
+    { "aead128",             bench_aead128 },
+    { "aead-turbo128",       bench_aead_turbo128 },
+};
+
+//-------------------------------------------------------
+static int bench_cmp(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+//-------------------------------------------------------
+static bench_stat_t bench_stat(double *v, uint32_t n)
+{
+    bench_stat_t st;
+
+    qsort(v, n, sizeof(double), bench_cmp);
+    st.min = v[0];
+    st.max = v[n - 1];
+    st.median = (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+
+    return st;
+}
+
+// Per call cost of fn(in, len): ticks and ns of every sample, each
+// sample timing enough calls to last about BENCH_SAMPLE_NS
+//-------------------------------------------------------
+static uint32_t bench_measure(bench_fn_t fn, const uint8_t *in, size_t len, uint32_t samples,
+                              double *ticks, double *ns, uint64_t *iterations)
+{
+    uint64_t iters = 1;
+    uint64_t c0, c1, i;
+    double t0, t1;
+    uint32_t k;
+
+    // warm up and scale the iteration count
+    for(;;)
+    {
+        t0 = bench_now_ns();
+        for(i = 0; i < iters; i++)
+        {
+            fn(in, len);
+        }
+        t1 = bench_now_ns();
+
+        if (t1 - t0 >= BENCH_SAMPLE_NS)
+        {
+            break;
+        }
+        iters = (t1 - t0 < BENCH_SAMPLE_NS / 16) ? iters * 16 : iters * 2;
+    }
+
+    if ( (1 == iters) && (t1 - t0 > BENCH_LONG_NS) && (samples > BENCH_MIN_SAMPLES) )
+    {
+        samples = BENCH_MIN_SAMPLES;
+    }
+
+    for(k = 0; k < samples; k++)
+    {
+        t0 = bench_now_ns();
+        c0 = bench_ticks();
+        for(i = 0; i < iters; i++)
+        {
+            fn(in, len);
+        }
+        c1 = bench_ticks();
+        t1 = bench_now_ns();
+
+        ticks[k] = (double)(c1 - c0) / (double)iters;
+        ns[k] = (t1 - t0) / (double)iters;
+    }
+
+    *iterations = iters;
+    return samples;
+}
+
+//-------------------------------------------------------
+static void bench_print_stat(FILE *out, const char *name, bench_stat_t st, int last)
+{
+    fprintf(out, "\"%s\": {\"median\": %.4f, \"min\": %.4f, \"max\": %.4f}%s",
+            name, st.median, st.min, st.max, last ? "" : ", ");
+}
+
+// Bare permutation cost of the sponge kernels and every multi-lane backend
+//-------------------------------------------------------
+static void bench_permutations(FILE *out, uint32_t samples)
+{
+    static const char *scalar[] = { "scalar-reference", "scalar-unrolled", "scalar-interleaved" };
+    static const char *impls[] = { "generic", "avx2", "avx512" };
+    static uint64_t s[25 * KECCAK_MAX_LANES];
+    double ticks[BENCH_MAX_SAMPLES], ns[BENCH_MAX_SAMPLES];
+    const keccak_impl_t *impl;
+    const char *name;
+    void (*permute)(uint64_t *, uint32_t);
+    uint64_t iters, c0, c1, i;
+    double t0, t1;
+    uint32_t lanes, k, j;
+    int first = 1;
+
+    fprintf(out, "  \"permutation\": [\n");
+
+    for(j = 0; j < 3 + sizeof(impls) / sizeof(impls[0]); j++)
+    {
+        if (j < 3)
+        {
+            name = scalar[j];
+            permute = (0 == j) ? keccak_fn : (1 == j) ? keccak_fn_unrolled : keccak_fn_interleaved;
+            lanes = 1;
+        }
+        else
+        {
+            impl = keccak_select_impl(impls[j - 3]);
+            if (NULL == impl)
+            {
+                continue;
+            }
+            name = impl->name;
+            permute = impl->permute;
+            lanes = impl->lanes;
+        }
+
+        for(iters = 1;; iters *= 2)
+        {
+            t0 = bench_now_ns();
+            for(i = 0; i < iters; i++)
+            {
+                permute(s, KECCAK_ROUNDS);
+            }
+            if (bench_now_ns() - t0 >= BENCH_SAMPLE_NS)
+            {
+                break;
+            }
+        }
+
+        for(k = 0; k < samples; k++)
+        {
+            t0 = bench_now_ns();
+            c0 = bench_ticks();
+            for(i = 0; i < iters; i++)
+            {
+                permute(s, KECCAK_ROUNDS);
+            }
+            c1 = bench_ticks();
+            t1 = bench_now_ns();
+            ticks[k] = (double)(c1 - c0) / (double)iters;
+            ns[k] = (t1 - t0) / (double)iters;
+        }
+
+        fprintf(out, "%s    {\"kernel\": \"%s\", \"lanes\": %u, ", first ? "" : ",\n", name, lanes);
+        if (bench_tsc_ghz > 0)
+        {
+            bench_print_stat(out, "cycles", bench_stat(ticks, samples), 0);
+        }
+        bench_print_stat(out, "ns", bench_stat(ns, samples), 1);
+        fprintf(out, "}");
+        first = 0;
+    }
+
+    keccak_select_impl(NULL);
+    fprintf(out, "\n  ],\n");
+}
+
+//-------------------------------------------------------
+static void bench_modes_run(FILE *out, const uint8_t *in, const bench_opts_t *opts)
+{
+    double ticks[BENCH_MAX_SAMPLES], ns[BENCH_MAX_SAMPLES];
+    double per_byte[BENCH_MAX_SAMPLES], gbps[BENCH_MAX_SAMPLES];
+    uint64_t iters;
+    uint32_t samples, m, k;
+    size_t len;
+    int progress = isatty(STDERR_FILENO);
+    int first = 1;
+
+    fprintf(out, "  \"results\": [\n");
+
+    for(m = 0; m < sizeof(bench_modes) / sizeof(bench_modes[0]); m++)
+    {
+        if ( (NULL != opts->filter) && (NULL == strstr(bench_modes[m].name, opts->filter)) )
+        {
+            continue;
+        }
+
+        // 0, then powers of 4 from 16 bytes up to max_len
+        for(len = 0; len <= opts->max_len; len = (len ? len * 4 : 16))
+        {
+            samples = bench_measure(bench_modes[m].fn, in, len, opts->samples, ticks, ns, &iters);
+
+            for(k = 0; k < samples; k++)
+            {
+                per_byte[k] = len ? ticks[k] / (double)len : 0;
+                gbps[k] = len ? (double)len / ns[k] : 0;
+            }
+
+            fprintf(out, "%s    {\"mode\": \"%s\", \"size\": %zu, \"iterations\": %llu, \"samples\": %u, ",
+                    first ? "" : ",\n", bench_modes[m].name, len, (unsigned long long)iters, samples);
+            if (bench_tsc_ghz > 0)
+            {
+                bench_print_stat(out, "cycles_per_call", bench_stat(ticks, samples), 0);
+                if (len)
+                {
+                    bench_print_stat(out, "cycles_per_byte", bench_stat(per_byte, samples), 0);
+                }
+            }
+            if (len)
+            {
+                bench_print_stat(out, "gb_per_s", bench_stat(gbps, samples), 0);
+            }
+            bench_print_stat(out, "ns_per_call", bench_stat(ns, samples), 1);
+            fprintf(out, "}");
+            fflush(out);
+            first = 0;
+
+            if (progress)
+            {
+                fprintf(stderr, "%-20s %10zu B  %12.1f ns\r", bench_modes[m].name, len, ns[samples / 2]);
+            }
+        }
+    }
+
+    if (progress)
+    {
+        fprintf(stderr, "%60s\r", "");
+    }
+    fprintf(out, "\n  ]\n");
+}
+
+// Latency mode: every size from 0 to a few rate blocks, each call timed
+// on its own
+//-------------------------------------------------------
+static const bench_latency_mode_t bench_latency_modes[] =
+{
+    { "sha3-224",      SHA3_224 },
+    { "sha3-256",      SHA3_256 },
+    { "sha3-384",      SHA3_384 },
+    { "sha3-512",      SHA3_512 },
+    { "shake128",      SHAKE128 },
+    { "shake256",      SHAKE256 },
+    { "turboshake128", TURBOSHAKE128 },
+};
+
+typedef enum
+{
+    BENCH_API_ONESHOT = 0,                     // SHA3()
+    BENCH_API_STREAM,                          // sha3_init/sha3_update/sha3_final
+    BENCH_API_FIXED                            // SHA3_32/SHA3_64, 32 and 64 bytes only
+} bench_api_t;
+
+static const char *bench_api_names[] = { "oneshot", "init_update_final", "fixed" };
+
+//-------------------------------------------------------
+static inline uint64_t bench_lat_now(void)
+{
+    return (bench_tsc_ghz > 0) ? bench_ticks() : (uint64_t)bench_now_ns();
+}
+
+//-------------------------------------------------------
+static void bench_lat_call(bench_api_t api, sha3_hash_modes_t mode, const uint8_t *in, size_t len)
+{
+    sha3_ctx_t ctx;
+
+    switch(api)
+    {
+        case BENCH_API_ONESHOT:
+            SHA3(mode, in, len, bench_out);
+            break;
+        case BENCH_API_STREAM:
+            sha3_init(mode, &ctx);
+            sha3_update(&ctx, in, len);
+            sha3_final(&ctx, bench_out);
+            break;
+        case BENCH_API_FIXED:
+            (32 == len) ? SHA3_32(mode, in, bench_out) : SHA3_64(mode, in, bench_out);
+            break;
+    }
+}
+
+//-------------------------------------------------------
+static int bench_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+// Sorted per-call times, value at quantile q
+//-------------------------------------------------------
+static uint64_t bench_quantile(const uint64_t *v, uint32_t n, double q)
+{
+    uint32_t i = (uint32_t)(q * (double)n);
+
+    return v[(i < n) ? i : n - 1];
+}
+
+// Cost of reading the timer twice, not subtracted from the results
+//-------------------------------------------------------
+static uint64_t bench_lat_overhead(uint64_t *v, uint32_t calls)
+{
+    uint64_t t0;
+    uint32_t k;
+
+    for(k = 0; k < calls; k++)
+    {
+        t0 = bench_lat_now();
+        v[k] = bench_lat_now() - t0;
+    }
+    qsort(v, calls, sizeof(uint64_t), bench_cmp_u64);
+
+    return bench_quantile(v, calls, 0.5);
+}
+
+//-------------------------------------------------------
+static void bench_latency_run(FILE *out, const uint8_t *in, const bench_opts_t *opts)
+{
+    uint64_t *v;
+    uint64_t t0;
+    sha3_ctx_t ctx;
+    size_t len, max_len;
+    uint32_t m, a, k, bs;
+    int progress = isatty(STDERR_FILENO);
+    int first = 1;
+
+    v = (uint64_t *)malloc(opts->calls * sizeof(uint64_t));
+    if (NULL == v)
+    {
+        return;
+    }
+
+    fprintf(out, "  \"unit\": \"%s\",\n", (bench_tsc_ghz > 0) ? "cycles" : "ns");
+    fprintf(out, "  \"calls\": %u,\n", opts->calls);
+    fprintf(out, "  \"timer_overhead\": %llu,\n", (unsigned long long)bench_lat_overhead(v, opts->calls));
+    fprintf(out, "  \"latency\": [\n");
+
+    for(m = 0; m < sizeof(bench_latency_modes) / sizeof(bench_latency_modes[0]); m++)
+    {
+        if ( (NULL != opts->filter) && (NULL == strstr(bench_latency_modes[m].name, opts->filter)) )
+        {
+            continue;
+        }
+
+        sha3_init(bench_latency_modes[m].mode, &ctx);
+        bs = ctx.bs;
+        max_len = (size_t)bs * opts->blocks;
+
+        for(len = 0; len <= max_len; len++)
+        {
+            // the APIs take turns on every size, drift hits them alike
+            for(a = BENCH_API_ONESHOT; a <= BENCH_API_FIXED; a++)
+            {
+                if ( (BENCH_API_FIXED == a) && (32 != len) && (64 != len) )
+                {
+                    continue;
+                }
+
+                for(k = 0; k < BENCH_LAT_WARMUP; k++)
+                {
+                    bench_lat_call((bench_api_t)a, bench_latency_modes[m].mode, in, len);
+                }
+
+                for(k = 0; k < opts->calls; k++)
+                {
+                    t0 = bench_lat_now();
+                    bench_lat_call((bench_api_t)a, bench_latency_modes[m].mode, in, len);
+                    v[k] = bench_lat_now() - t0;
+                }
+                qsort(v, opts->calls, sizeof(uint64_t), bench_cmp_u64);
+
+                // a size that is a multiple of the rate starts a new block:
+                // the padding needs one more permutation than len - 1
+                fprintf(out, "%s    {\"mode\": \"%s\", \"api\": \"%s\", \"size\": %zu, \"rate\": %u, "
+                        "\"permutations\": %zu, \"block_boundary\": %s, "
+                        "\"min\": %llu, \"p50\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu}",
+                        first ? "" : ",\n", bench_latency_modes[m].name, bench_api_names[a], len, bs,
+                        len / bs + 1, ( (len != 0) && (0 == len % bs) ) ? "true" : "false",
+                        (unsigned long long)v[0],
+                        (unsigned long long)bench_quantile(v, opts->calls, 0.5),
+                        (unsigned long long)bench_quantile(v, opts->calls, 0.99),
+                        (unsigned long long)bench_quantile(v, opts->calls, 0.999),
+                        (unsigned long long)v[opts->calls - 1]);
+                first = 0;
+            }
+
+            if (progress)
+            {
+                fprintf(stderr, "%-20s %10zu B\r", bench_latency_modes[m].name, len);
+            }
+        }
+        fflush(out);
+    }
+
+    if (progress)
+    {
+        fprintf(stderr, "%60s\r", "");
+    }
+    fprintf(out, "\n  ]\n");
+
+    free(v);
+}
+
+//-------------------------------------------------------
+static void bench_usage(FILE *out)
+{
+    fprintf(out,
+            "Usage: sha3_bench [OPTION]...\n"
+            "Measures every SHA3 mode from 0 bytes up to the maximum size in powers of 4\n"
+            "and the bare Keccak-f[1600] permutation, prints JSON on standard output.\n"
+            "Cycles are TSC ticks, median/min/max are over the samples.\n"
+            "\n"
+            "  -c, --cpu=N        pin to CPU N (default: the current one)\n"
+            "  -f, --filter=STR   only modes whose name contains STR\n"
+            "  -m, --max=BYTES    largest message, default 1073741824\n"
+            "  -o, --output=FILE  write JSON to FILE\n"
+            "  -r, --samples=N    samples per measurement, default %u\n"
+            "  -l, --latency[=N]  latency mode instead: every size from 0 to N rate blocks\n"
+            "                     (default %u), p50/p99/p999 of single calls, one-shot\n"
+            "                     against init/update/final\n"
+            "  -n, --calls=N      timed calls per size in latency mode, default %u\n"
+            "  -h, --help         display this help and exit\n",
+            BENCH_DEF_SAMPLES, BENCH_DEF_BLOCKS, BENCH_DEF_CALLS);
+}
+
+//-------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    static const struct option long_opts[] =
+    {
+        { "cpu",     required_argument, NULL, 'c' },
+        { "filter",  required_argument, NULL, 'f' },
+        { "max",     required_argument, NULL, 'm' },
+        { "output",  required_argument, NULL, 'o' },
+        { "samples", required_argument, NULL, 'r' },
+        { "latency", optional_argument, NULL, 'l' },
+        { "calls",   required_argument, NULL, 'n' },
+        { "help",    no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    bench_opts_t opts;
+    cpu_set_t set;
+    FILE *out = stdout;
+    uint8_t *in;
+    char *end;
+    long value;
+    size_t i;
+    int c;
+
+    opts.max_len = BENCH_DEF_MAX_LEN;
+    opts.samples = BENCH_DEF_SAMPLES;
+    opts.cpu = sched_getcpu();
+    opts.filter = NULL;
+    opts.blocks = 0;
+    opts.calls = BENCH_DEF_CALLS;
+
+    while ( (c = getopt_long(argc, argv, "c:f:m:o:r:l::n:h", long_opts, NULL)) != -1 )
+    {
+        switch(c)
+        {
+            case 'c':
+                opts.cpu = atoi(optarg);
+                break;
+            case 'f':
+                opts.filter = optarg;
+                break;
+            case 'm':
+                opts.max_len = (size_t)strtoull(optarg, NULL, 0);
+                break;
+            case 'o':
+                out = fopen(optarg, "w");
+                if (NULL == out)
+                {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            case 'r':
+                opts.samples = (uint32_t)atoi(optarg);
+                if ( (opts.samples < 1) || (opts.samples > BENCH_MAX_SAMPLES) )
+                {
+                    fprintf(stderr, "sha3_bench: samples have to be 1..%u\n", BENCH_MAX_SAMPLES);
+                    return 1;
+                }
+                break;
+            case 'l':
+                value = (NULL == optarg) ? BENCH_DEF_BLOCKS : strtol(optarg, &end, 10);
+                if ( ( (NULL != optarg) && ('\0' != *end) ) || (value < 1) || (value > BENCH_MAX_BLOCKS) )
+                {
+                    fprintf(stderr, "sha3_bench: latency blocks have to be 1..%u\n", BENCH_MAX_BLOCKS);
+                    return 1;
+                }
+                opts.blocks = (uint32_t)value;
+                break;
+            case 'n':
+                value = strtol(optarg, &end, 10);
+                if ( ('\0' != *end) || (value < 1) || (value > BENCH_MAX_CALLS) )
+                {
+                    fprintf(stderr, "sha3_bench: calls have to be 1..%u\n", BENCH_MAX_CALLS);
+                    return 1;
+                }
+                opts.calls = (uint32_t)value;
+                break;
+            case 'h':
+                bench_usage(stdout);
+                return 0;
+            default:
+                bench_usage(stderr);
+                return 1;
+        }
+    }
+
+    // one thread on one core: no migrations, parallel modes run inline
+    CPU_ZERO(&set);
+    CPU_SET(opts.cpu < 0 ? 0 : opts.cpu, &set);
+    if (0 != sched_setaffinity(0, sizeof(set), &set))
+    {
+        perror("sched_setaffinity");
+        opts.cpu = -1;
+    }
+    sha3_set_threads(1);
+
+    // latency sizes stay within a few blocks
+    if (0 != opts.blocks)
+    {
+        opts.max_len = (size_t)opts.blocks * SHA3_MAX_RATE_LEN + 1;
+    }
+
+    in = (uint8_t *)malloc(opts.max_len ? opts.max_len : 1);
+    if (NULL == in)
+    {
+        fprintf(stderr, "sha3_bench: can not allocate %zu bytes\n", opts.max_len);
+        return 1;
+    }
+    for(i = 0; i < opts.max_len; i++)
+    {
+        in[i] = (uint8_t)(i * 131 + 7);
+    }
+
+    hmac_sha3_init(HMAC_SHA3_256, &bench_hmac_ctx, bench_key, sizeof(bench_key));
+
+#ifdef BENCH_HAVE_TSC
+    bench_tsc_ghz = bench_calibrate_tsc();
+#endif
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"cpu\": %d,\n", opts.cpu);
+    fprintf(out, "  \"timer\": \"%s\",\n", (bench_tsc_ghz > 0) ? "tsc" : "clock_monotonic");
+    fprintf(out, "  \"tsc_ghz\": %.4f,\n", bench_tsc_ghz);
+#if defined(SHA3_KECCAK_INTERLEAVED)
+    fprintf(out, "  \"sponge_kernel\": \"interleaved\",\n");
+#elif defined(SHA3_KECCAK_UNROLLED)
+    fprintf(out, "  \"sponge_kernel\": \"unrolled\",\n");
+#else
+    fprintf(out, "  \"sponge_kernel\": \"reference\",\n");
+#endif
+    fprintf(out, "  \"batch_impl\": \"%s\",\n", keccak_get_impl()->name);
+    fprintf(out, "  \"batch_lanes\": %u,\n", BENCH_BATCH);
+
+    if (0 != opts.blocks)
+    {
+        bench_latency_run(out, in, &opts);
+    }
+    else
+    {
+        bench_permutations(out, opts.samples);
+        bench_modes_run(out, in, &opts);
+    }
+
+    fprintf(out, "}\n");
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    free(in);
+
+    return 0;
+}
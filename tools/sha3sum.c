@@ -0,0 +1,738 @@
+/**
+* @file  sha3sum.c
+* @brief Print or check SHA3 checksums, coreutils style
+* @author Sergii Sidorov(sergii.sidorov@ukr.net)
+*
+* @date  02.11.2013
+*
+* The MIT License (MIT)
+*
+* Copyright (c) 2013 Sergii Sidorov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "sha3.h"
+#include "sha3_pool.h"
+
+// Files up to this size are read whole and hashed by the multi-message kernel
+#define SUM_SMALL_MAX       (64 * 1024)
+// Files handed to a worker at once, also the largest multi-message batch
+#define SUM_FILES_PER_JOB   32
+// Files hashed before their results are printed
+#define SUM_WINDOW          4096
+
+typedef struct sum_entry
+{
+    char              *name;
+    sha3_hash_modes_t  mode;
+    int                err;                    // errno of open/read, 0 if hashed
+    uint8_t            digest[SHA3_512_HASH_LEN];
+    uint8_t            expect[SHA3_512_HASH_LEN];
+} sum_entry_t;
+
+typedef struct sum_opts
+{
+    sha3_hash_modes_t mode;
+    int               binary;
+    int               check;
+    int               quiet;
+    int               status;
+    int               warn;
+    int               strict;
+} sum_opts_t;
+
+typedef struct sum_stats
+{
+    uint64_t mismatched;
+    uint64_t unreadable;
+    uint64_t malformed;
+    uint64_t verified;
+} sum_stats_t;
+
+static const char *prog_name = "sha3sum";
+
+//-------------------------------------------------------
+static uint32_t sum_digest_len(sha3_hash_modes_t mode)
+{
+    switch(mode)
+    {
+        case SHA3_224:
+            return SHA3_224_HASH_LEN;
+        case SHA3_256:
+            return SHA3_256_HASH_LEN;
+        case SHA3_384:
+            return SHA3_384_HASH_LEN;
+        default:
+            return SHA3_512_HASH_LEN;
+    }
+}
+
+//-------------------------------------------------------
+static int sum_mode_from_bits(long bits, sha3_hash_modes_t *mode)
+{
+    switch(bits)
+    {
+        case 224:
+            *mode = SHA3_224;
+            return 0;
+        case 256:
+            *mode = SHA3_256;
+            return 0;
+        case 384:
+            *mode = SHA3_384;
+            return 0;
+        case 512:
+            *mode = SHA3_512;
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+// Whole small file into buf (capacity SUM_SMALL_MAX). Returns its length,
+// or -1 with the rest of the file absorbed into ctx when it outgrew buf.
+//-------------------------------------------------------
+static ssize_t sum_read_small(int fd, uint8_t *buf, sha3_ctx_t *ctx, int *err)
+{
+    size_t len = 0;
+    ssize_t n;
+
+    while (len < SUM_SMALL_MAX)
+    {
+        n = read(fd, buf + len, SUM_SMALL_MAX - len);
+        if (n < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            *err = errno;
+            return -1;
+        }
+        if (0 == n)
+        {
+            return (ssize_t)len;
+        }
+        len += (size_t)n;
+    }
+
+    // grew since fstat, continue as a stream
+    errno = 0;
+    if ( (SHA3_OK != sha3_update(ctx, buf, len)) ||
+         (SHA3_OK != sha3_update_fd(ctx, fd)) )
+    {
+        *err = errno ? errno : EIO;
+    }
+
+    return -1;
+}
+
+//-------------------------------------------------------
+static void sum_flush(sum_entry_t **pending, const uint8_t **in, size_t *len, uint32_t *num)
+{
+    uint8_t *out[SUM_FILES_PER_JOB];
+    uint32_t i;
+
+    if (0 == *num)
+    {
+        return;
+    }
+
+    for(i = 0; i < *num; i++)
+    {
+        out[i] = pending[i]->digest;
+    }
+
+    sha3_hash_many(pending[0]->mode, in, len, out, *num);
+    *num = 0;
+}
+
+// Hash entries [index * SUM_FILES_PER_JOB, ...) of the window. Large and
+// special files are hashed one by one on the single-stream path, small
+// regular files are collected and hashed in one multi-message batch.
+//-------------------------------------------------------
+static void sum_job(void *arg, uint32_t index)
+{
+    sum_entry_t *entry = (sum_entry_t *)arg;
+    sum_entry_t *pending[SUM_FILES_PER_JOB];
+    const uint8_t *in[SUM_FILES_PER_JOB];
+    size_t len[SUM_FILES_PER_JOB];
+    uint32_t num = 0;
+    uint8_t *arena = NULL;
+    size_t used = 0;
+    sum_entry_t *e;
+    struct stat st;
+    sha3_ctx_t ctx;
+    ssize_t n;
+    uint32_t i;
+    int fd;
+
+    for(i = 0; i < SUM_FILES_PER_JOB; i++)
+    {
+        e = &entry[index * SUM_FILES_PER_JOB + i];
+        if (NULL == e->name)
+        {
+            break;
+        }
+
+        if (0 == strcmp(e->name, "-"))
+        {
+            fd = STDIN_FILENO;
+        }
+        else
+        {
+            do
+            {
+                fd = open(e->name, O_RDONLY);
+            } while ( (fd < 0) && (EINTR == errno) );
+        }
+
+        if (fd < 0)
+        {
+            e->err = errno;
+            continue;
+        }
+
+        if ( (0 == fstat(fd, &st)) && S_ISREG(st.st_mode) && (st.st_size <= SUM_SMALL_MAX) &&
+             (lseek(fd, 0, SEEK_CUR) == 0) )
+        {
+            if (NULL == arena)
+            {
+                arena = (uint8_t *)malloc((size_t)SUM_FILES_PER_JOB * SUM_SMALL_MAX);
+            }
+
+            if (NULL != arena)
+            {
+                if ( (num != 0) && (pending[0]->mode != e->mode) )
+                {
+                    sum_flush(pending, in, len, &num);
+                    used = 0;
+                }
+
+                sha3_init(e->mode, &ctx);
+                n = sum_read_small(fd, arena + used, &ctx, &e->err);
+                if (n >= 0)
+                {
+                    pending[num] = e;
+                    in[num] = arena + used;
+                    len[num] = (size_t)n;
+                    num++;
+                    used += (size_t)n;
+                }
+                else if (0 == e->err)
+                {
+                    sha3_final(&ctx, e->digest);
+                }
+
+                if (fd != STDIN_FILENO)
+                {
+                    close(fd);
+                }
+                continue;
+            }
+        }
+
+        errno = 0;
+        if (SHA3_OK != sha3_fd(e->mode, fd, e->digest))
+        {
+            e->err = errno ? errno : EIO;
+        }
+
+        if (fd != STDIN_FILENO)
+        {
+            close(fd);
+        }
+    }
+
+    sum_flush(pending, in, len, &num);
+    free(arena);
+}
+
+// Names with a backslash or a newline are escaped and the line gets a
+// leading backslash, as coreutils does
+//-------------------------------------------------------
+static int sum_needs_escape(const char *name)
+{
+    return (NULL != strpbrk(name, "\\\n\r"));
+}
+
+//-------------------------------------------------------
+static void sum_print_name(const char *name, int escape)
+{
+    for(; *name; name++)
+    {
+        if (escape && ('\\' == *name))
+        {
+            fputs("\\\\", stdout);
+        }
+        else if (escape && ('\n' == *name))
+        {
+            fputs("\\n", stdout);
+        }
+        else if (escape && ('\r' == *name))
+        {
+            fputs("\\r", stdout);
+        }
+        else
+        {
+            putchar(*name);
+        }
+    }
+}
+
+//-------------------------------------------------------
+static void sum_print_digest(const sum_entry_t *e, const sum_opts_t *opts)
+{
+    uint32_t d = sum_digest_len(e->mode);
+    int escape = sum_needs_escape(e->name);
+    uint32_t i;
+
+    if (escape)
+    {
+        putchar('\\');
+    }
+
+    for(i = 0; i < d; i++)
+    {
+        printf("%02x", e->digest[i]);
+    }
+
+    putchar(' ');
+    putchar(opts->binary ? '*' : ' ');
+    sum_print_name(e->name, escape);
+    putchar('\n');
+}
+
+// Result of one --check entry
+//-------------------------------------------------------
+static void sum_print_check(const sum_entry_t *e, const sum_opts_t *opts, sum_stats_t *stats)
+{
+    const char *result;
+    int escape;
+    int ok;
+
+    if (e->err)
+    {
+        stats->unreadable++;
+        fprintf(stderr, "%s: %s: %s\n", prog_name, e->name, strerror(e->err));
+        result = "FAILED open or read";
+        ok = 0;
+    }
+    else
+    {
+        ok = (0 == memcmp(e->digest, e->expect, sum_digest_len(e->mode)));
+        result = ok ? "OK" : "FAILED";
+        if (ok)
+        {
+            stats->verified++;
+        }
+        else
+        {
+            stats->mismatched++;
+        }
+    }
+
+    if (opts->status || (ok && opts->quiet))
+    {
+        return;
+    }
+
+    escape = sum_needs_escape(e->name);
+    if (escape)
+    {
+        putchar('\\');
+    }
+    sum_print_name(e->name, escape);
+    printf(": %s\n", result);
+}
+
+// Hash a filled window on the pool and print it in order
+//-------------------------------------------------------
+static void sum_run_window(sum_entry_t *entry, uint32_t num, const sum_opts_t *opts, sum_stats_t *stats)
+{
+    uint32_t i;
+
+    entry[num].name = NULL;
+    sha3_pool_run((num + SUM_FILES_PER_JOB - 1) / SUM_FILES_PER_JOB, sum_job, entry);
+
+    for(i = 0; i < num; i++)
+    {
+        if (opts->check)
+        {
+            sum_print_check(&entry[i], opts, stats);
+            free(entry[i].name);
+        }
+        else if (entry[i].err)
+        {
+            stats->unreadable++;
+            fprintf(stderr, "%s: %s: %s\n", prog_name, entry[i].name, strerror(entry[i].err));
+        }
+        else
+        {
+            sum_print_digest(&entry[i], opts);
+        }
+    }
+
+    memset(entry, 0, sizeof(sum_entry_t) * (num + 1));
+}
+
+//-------------------------------------------------------
+static int sum_hex_value(char c)
+{
+    if ( (c >= '0') && (c <= '9') )
+    {
+        return c - '0';
+    }
+    if ( (c >= 'a') && (c <= 'f') )
+    {
+        return c - 'a' + 10;
+    }
+    if ( (c >= 'A') && (c <= 'F') )
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// "<hex>  <name>" or "<hex> *<name>", optionally prefixed with a backslash
+// when the name is escaped. The hex length gives the mode.
+//-------------------------------------------------------
+static int sum_parse_line(char *line, sum_entry_t *e)
+{
+    size_t hex_len = 0;
+    int escaped = 0;
+    char *src, *dst;
+    long bits;
+    int hi, lo;
+    size_t i;
+
+    if ('\\' == *line)
+    {
+        escaped = 1;
+        line++;
+    }
+
+    while (sum_hex_value(line[hex_len]) >= 0)
+    {
+        hex_len++;
+    }
+
+    bits = (long)hex_len * 4;
+    if ( (0 != sum_mode_from_bits(bits, &e->mode)) || (' ' != line[hex_len]) ||
+         ( (' ' != line[hex_len + 1]) && ('*' != line[hex_len + 1]) ) ||
+         ('\0' == line[hex_len + 2]) )
+    {
+        return -1;
+    }
+
+    for(i = 0; i < hex_len / 2; i++)
+    {
+        hi = sum_hex_value(line[2 * i]);
+        lo = sum_hex_value(line[2 * i + 1]);
+        e->expect[i] = (uint8_t)((hi << 4) | lo);
+    }
+
+    src = line + hex_len + 2;
+    e->name = (char *)malloc(strlen(src) + 1);
+    if (NULL == e->name)
+    {
+        return -1;
+    }
+
+    for(dst = e->name; *src; src++)
+    {
+        if (escaped && ('\\' == src[0]) && ('\\' == src[1]))
+        {
+            *dst++ = '\\';
+            src++;
+        }
+        else if (escaped && ('\\' == src[0]) && ('n' == src[1]))
+        {
+            *dst++ = '\n';
+            src++;
+        }
+        else if (escaped && ('\\' == src[0]) && ('r' == src[1]))
+        {
+            *dst++ = '\r';
+            src++;
+        }
+        else
+        {
+            *dst++ = *src;
+        }
+    }
+    *dst = '\0';
+
+    return 0;
+}
+
+//-------------------------------------------------------
+static int sum_check_file(const char *path, sum_entry_t *entry, const sum_opts_t *opts, sum_stats_t *stats)
+{
+    FILE *f;
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t n;
+    uint64_t line_num = 0;
+    uint64_t lines_ok = 0;
+    uint32_t num = 0;
+
+    f = strcmp(path, "-") ? fopen(path, "r") : stdin;
+    if (NULL == f)
+    {
+        fprintf(stderr, "%s: %s: %s\n", prog_name, path, strerror(errno));
+        return -1;
+    }
+
+    while ( (n = getline(&line, &cap, f)) >= 0 )
+    {
+        line_num++;
+
+        while ( (n > 0) && ( ('\n' == line[n - 1]) || ('\r' == line[n - 1]) ) )
+        {
+            line[--n] = '\0';
+        }
+
+        if ( (0 == n) || ('#' == line[0]) )
+        {
+            continue;
+        }
+
+        if (0 != sum_parse_line(line, &entry[num]))
+        {
+            stats->malformed++;
+            if (opts->warn)
+            {
+                fprintf(stderr, "%s: %s: %llu: improperly formatted SHA3 checksum line\n",
+                        prog_name, path, (unsigned long long)line_num);
+            }
+            continue;
+        }
+
+        lines_ok++;
+        if (++num == SUM_WINDOW)
+        {
+            sum_run_window(entry, num, opts, stats);
+            num = 0;
+        }
+    }
+
+    if (num != 0)
+    {
+        sum_run_window(entry, num, opts, stats);
+    }
+
+    free(line);
+    if (f != stdin)
+    {
+        fclose(f);
+    }
+
+    if (0 == lines_ok)
+    {
+        fprintf(stderr, "%s: %s: no properly formatted SHA3 checksum lines found\n", prog_name, path);
+        return -1;
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------
+static void sum_usage(FILE *out)
+{
+    fprintf(out,
+            "Usage: %s [OPTION]... [FILE]...\n"
+            "Print or check SHA3 checksums. With no FILE, or when FILE is -, read standard input.\n"
+            "\n"
+            "  -a, --algorithm=BITS  224, 256 (default), 384 or 512\n"
+            "  -b, --binary          read in binary mode (marks names with '*')\n"
+            "  -c, --check           read checksums from the FILEs and check them\n"
+            "  -j, --jobs=N          hash with N threads, 0 for one per CPU (default)\n"
+            "  -t, --text            read in text mode (default)\n"
+            "\n"
+            "The following options are useful only when verifying checksums:\n"
+            "      --quiet           don't print OK for each successfully verified file\n"
+            "      --status          don't output anything, status code shows success\n"
+            "      --strict          exit non-zero for improperly formatted checksum lines\n"
+            "  -w, --warn            warn about improperly formatted checksum lines\n"
+            "\n"
+            "      --help            display this help and exit\n",
+            prog_name);
+}
+
+//-------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    enum { OPT_QUIET = 256, OPT_STATUS, OPT_STRICT, OPT_HELP };
+    static const struct option long_opts[] =
+    {
+        { "algorithm", required_argument, NULL, 'a' },
+        { "binary",    no_argument,       NULL, 'b' },
+        { "check",     no_argument,       NULL, 'c' },
+        { "jobs",      required_argument, NULL, 'j' },
+        { "text",      no_argument,       NULL, 't' },
+        { "warn",      no_argument,       NULL, 'w' },
+        { "quiet",     no_argument,       NULL, OPT_QUIET },
+        { "status",    no_argument,       NULL, OPT_STATUS },
+        { "strict",    no_argument,       NULL, OPT_STRICT },
+        { "help",      no_argument,       NULL, OPT_HELP },
+        { NULL, 0, NULL, 0 }
+    };
+    static char stdin_name[] = "-";
+    char *stdin_list[] = { stdin_name };
+    char **files;
+    int files_num;
+    sum_opts_t opts;
+    sum_stats_t stats;
+    sum_entry_t *entry;
+    char *end;
+    long value;
+    uint32_t num = 0;
+    int failed = 0;
+    int c, i;
+
+    memset(&opts, 0, sizeof(opts));
+    memset(&stats, 0, sizeof(stats));
+    opts.mode = SHA3_256;
+
+    while ( (c = getopt_long(argc, argv, "a:bcj:tw", long_opts, NULL)) != -1 )
+    {
+        switch(c)
+        {
+            case 'a':
+                value = strtol(optarg, &end, 10);
+                if ( ('\0' != *end) || (0 != sum_mode_from_bits(value, &opts.mode)) )
+                {
+                    fprintf(stderr, "%s: invalid algorithm: %s\n", prog_name, optarg);
+                    return 1;
+                }
+                break;
+            case 'b':
+                opts.binary = 1;
+                break;
+            case 'c':
+                opts.check = 1;
+                break;
+            case 'j':
+                value = strtol(optarg, &end, 10);
+                if ( ('\0' != *end) || (value < 0) )
+                {
+                    fprintf(stderr, "%s: invalid number of jobs: %s\n", prog_name, optarg);
+                    return 1;
+                }
+                sha3_set_threads((uint32_t)value);
+                break;
+            case 't':
+                opts.binary = 0;
+                break;
+            case 'w':
+                opts.warn = 1;
+                break;
+            case OPT_QUIET:
+                opts.quiet = 1;
+                break;
+            case OPT_STATUS:
+                opts.status = 1;
+                break;
+            case OPT_STRICT:
+                opts.strict = 1;
+                break;
+            case OPT_HELP:
+                sum_usage(stdout);
+                return 0;
+            default:
+                sum_usage(stderr);
+                return 1;
+        }
+    }
+
+    entry = (sum_entry_t *)calloc(SUM_WINDOW + 1, sizeof(sum_entry_t));
+    if (NULL == entry)
+    {
+        fprintf(stderr, "%s: %s\n", prog_name, strerror(ENOMEM));
+        return 1;
+    }
+
+    files = argv + optind;
+    files_num = argc - optind;
+    if (0 == files_num)
+    {
+        files = stdin_list;
+        files_num = 1;
+    }
+
+    for(i = 0; i < files_num; i++)
+    {
+        if (opts.check)
+        {
+            failed |= (0 != sum_check_file(files[i], entry, &opts, &stats));
+            continue;
+        }
+
+        entry[num].name = files[i];
+        entry[num].mode = opts.mode;
+        if (++num == SUM_WINDOW)
+        {
+            sum_run_window(entry, num, &opts, &stats);
+            num = 0;
+        }
+    }
+
+    if (num != 0)
+    {
+        sum_run_window(entry, num, &opts, &stats);
+    }
+
+    free(entry);
+
+    if (opts.check && !opts.status)
+    {
+        if (stats.malformed)
+        {
+            fprintf(stderr, "%s: WARNING: %llu line%s improperly formatted\n", prog_name,
+                    (unsigned long long)stats.malformed, (1 == stats.malformed) ? " is" : "s are");
+        }
+        if (stats.unreadable)
+        {
+            fprintf(stderr, "%s: WARNING: %llu listed file%s could not be read\n", prog_name,
+                    (unsigned long long)stats.unreadable, (1 == stats.unreadable) ? "" : "s");
+        }
+        if (stats.mismatched)
+        {
+            fprintf(stderr, "%s: WARNING: %llu computed checksum%s did NOT match\n", prog_name,
+                    (unsigned long long)stats.mismatched, (1 == stats.mismatched) ? "" : "s");
+        }
+    }
+
+    failed |= (0 != stats.unreadable) || (0 != stats.mismatched) ||
+              (opts.strict && (0 != stats.malformed));
+
+    return failed ? 1 : 0;
+}